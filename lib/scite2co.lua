@@ -87,24 +87,21 @@ end
 
 io.write("! AUTO-GENERATED FROM SCITE PROPERTY SET !\n\n")
 
--- print [lexer.test...] macro
+-- associate patterns with [lexer.set...] macro when registering lexers
+-- (the generated macros only set up styles, so they can be bundled)
 local shbang = expand(props["shbang."..language])
 local file_patterns = expand(props["file.patterns."..language])
-io.write([=[
-@[lexer.test.]=]..language:lower()..[=[]{
+local macro = "lexer.set."..language:lower()
+io.write([=[:Q[lexer.register]"F Q[lexer.register]"N
 ]=])
-if shbang then io.write([=[  _#!M]=]..shbang..[=[M[lexer.checkheader]"S -1 '
+if shbang then io.write([=[  3EA#!M]=]..shbang..[=[]=]..macro..[=[
 ]=]) end
-local patterns = {}
 for pattern in file_patterns:gmatch("[^;]+") do
-	table.insert(patterns, pattern)
-end
-for i, pattern in ipairs(patterns) do
-	io.write([=[  :EN]=]..pattern..[=[Q*]=])
-	if i ~= #patterns then io.write([=["S -1 ']=]) end
-	io.write("\n")
+	io.write([=[  2EA]=]..pattern..[=[]=]..macro..[=[
+]=])
 end
-io.write([=[}
+io.write([=[  
+' '
 
 ]=])
 
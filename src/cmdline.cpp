@@ -159,6 +159,7 @@ Cmdline::insert(const gchar *src)
 				/* automatically disable immediate editing modifier */
 				modifier_enabled = false;
 
+			changed_pos = MIN(changed_pos, len);
 			String::append(str, len, src);
 			len += src_len;
 			rubout_len = 0;
@@ -168,20 +169,26 @@ Cmdline::insert(const gchar *src)
 	/*
 	 * Parse/execute characters, one at a time so
 	 * undo tokens get emitted for the corresponding characters.
+	 * Interactive feedback is deferred to Cmdline::refresh(),
+	 * so inserting long strings does not refresh for
+	 * every character.
 	 */
 	while (pc < len) {
 		try {
-			Execute::step(str, pc+1);
+			Execute::step(str, pc+1, false);
 		} catch (Cmdline *new_cmdline) {
 			/*
 			 * Result of command line replacement (}):
 			 * Exchange command lines, avoiding
 			 * deep copying
 			 */
+			gsize changed = MIN(changed_pos, new_cmdline->pc);
+
 			undo.pop(new_cmdline->pc);
 
 			old_cmdline = *this;
 			*this = *new_cmdline;
+			changed_pos = changed;
 			new_cmdline->str = NULL;
 			macro_pc = repl_pc = pc;
 
@@ -210,7 +217,7 @@ Cmdline::insert(const gchar *src)
 				continue;
 			}
 
-			/* error is handled in Cmdline::keypress() */
+			/* error is handled in Cmdline::process_keypress() */
 			throw;
 		}
 
@@ -218,14 +225,40 @@ Cmdline::insert(const gchar *src)
 	}
 }
 
+/**
+ * Process a sequence of keypresses.
+ * Keys are processed exactly as if they had been
+ * typed one by one, but the command line is refreshed
+ * and echoed only once.
+ * This speeds up function key macros considerably.
+ *
+ * @param keys Keys to process (not null-terminated).
+ * @param keys_len Number of keys to process.
+ */
 void
-Cmdline::keypress(gchar key)
+Cmdline::keypress(const gchar *keys, gsize keys_len)
 {
 	/*
 	 * Cleanup messages,etc...
 	 */
 	interface.msg_clear();
+	interface.progress_begin();
+
+	for (gsize i = 0; i < keys_len; i++)
+		process_keypress(keys[i]);
+
+	refresh();
+
+	/*
+	 * Echo command line
+	 */
+	interface.cmdline_update(this);
+	changed_pos = len + rubout_len;
+}
 
+void
+Cmdline::process_keypress(gchar key)
+{
 	/*
 	 * Process immediate editing commands, inserting
 	 * characters as necessary into the command line.
@@ -258,6 +291,7 @@ Cmdline::keypress(gchar key)
 		last_cmdline = *this;
 		str = NULL;
 		len = rubout_len = 0;
+		changed_pos = 0;
 
 #ifdef HAVE_MALLOC_TRIM
 		/*
@@ -287,11 +321,38 @@ Cmdline::keypress(gchar key)
 		/* program counter could be messed up */
 		macro_pc = len;
 	}
+}
 
-	/*
-	 * Echo command line
-	 */
-	interface.cmdline_update(this);
+/**
+ * Provide interactive feedback for the current
+ * command line, e.g. perform pending insertions of
+ * string arguments.
+ * Undo tokens are attached to the last character of the
+ * command line, so the feedback is rolled back as soon
+ * as it is rubbed out.
+ * If refreshing fails, that character is rubbed out as well.
+ */
+void
+Cmdline::refresh(void)
+{
+	while (len) {
+		macro_pc = len;
+		pc = len-1;
+
+		try {
+			Execute::step(str, len);
+			break;
+		} catch (Error &error) {
+			error.add_frame(new Error::ToplevelFrame());
+			error.display_short();
+
+			undo.pop(pc);
+			len--;
+			rubout_len++;
+		}
+	}
+
+	macro_pc = pc = len;
 }
 
 void
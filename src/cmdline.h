@@ -18,6 +18,8 @@
 #ifndef __CMDLINE_H
 #define __CMDLINE_H
 
+#include <string.h>
+
 #include <glib.h>
 
 #include "memory.h"
@@ -49,8 +51,15 @@ public:
 	gsize rubout_len;
 	/** Program counter within the command-line macro */
 	guint pc;
+	/**
+	 * Position of the first character that changed since
+	 * the last interface update.
+	 * Everything before it is known to be unchanged, so the
+	 * interface does not have to compare the command lines.
+	 */
+	gsize changed_pos;
 
-	Cmdline() : str(NULL), len(0), rubout_len(0), pc(0) {}
+	Cmdline() : str(NULL), len(0), rubout_len(0), pc(0), changed_pos(0) {}
 	inline
 	~Cmdline()
 	{
@@ -63,12 +72,16 @@ public:
 		return str[i];
 	}
 
-	void keypress(gchar key);
+	void keypress(const gchar *keys, gsize keys_len);
+	inline void
+	keypress(gchar key)
+	{
+		keypress(&key, 1);
+	}
 	inline void
 	keypress(const gchar *keys)
 	{
-		while (*keys)
-			keypress(*keys++);
+		keypress(keys, strlen(keys));
 	}
 
 	void fnmacro(const gchar *name);
@@ -91,6 +104,10 @@ public:
 		gchar src[] = {key, '\0'};
 		insert(src);
 	}
+
+private:
+	void process_keypress(gchar key);
+	void refresh(void);
 } cmdline;
 
 extern bool quit_requested;
@@ -239,6 +239,36 @@ EOLReaderMem::convert_all(gsize *out_len)
 	return g_string_free(str, FALSE);
 }
 
+/**
+ * Perform EOL-normalization directly in the buffer
+ * passed to the constructor.
+ *
+ * Since the normalized data is never longer than
+ * the original data, all chunks can be moved to the
+ * beginning of the buffer.
+ * The result is null-terminated, so the buffer must have
+ * room for one more byte.
+ *
+ * @return The length of the normalized data.
+ */
+gsize
+EOLReaderMem::convert_in_place(void)
+{
+	gchar *start = buffer;
+	gsize len = 0;
+	const gchar *data;
+	gsize data_len;
+
+	while ((data = convert(data_len))) {
+		if (data != start+len)
+			memmove(start+len, data, data_len);
+		len += data_len;
+	}
+
+	start[len] = '\0';
+	return len;
+}
+
 /**
  * Perform EOL-normalization on a buffer (if enabled) and
  * pass it to the underlying data sink.
@@ -28,7 +28,10 @@
 namespace SciTECO {
 
 class EOLReader : public Object {
+protected:
 	gchar *buffer;
+
+private:
 	gsize read_len;
 	guint offset;
 	gsize block_len;
@@ -90,6 +93,7 @@ public:
 	            : EOLReader(buffer), buffer_len(_buffer_len) {}
 
 	gchar *convert_all(gsize *out_len = NULL);
+	gsize convert_in_place(void);
 };
 
 class EOLWriter : public Object {
@@ -59,6 +59,11 @@ public:
 	void load(void);
 
 	Topic *find(const gchar *name);
+	inline Topic *
+	first(void)
+	{
+		return (Topic *)min();
+	}
 
 	void set(const gchar *name, const gchar *filename,
 	         tecoInt pos = 0);
@@ -35,77 +35,66 @@ CursesInfoPopup::add(PopupEntryType type,
                      const gchar *name, bool highlight)
 {
 	size_t name_len = strlen(name);
-	Entry *entry = (Entry *)g_malloc(sizeof(Entry) + name_len + 1);
+	Entry entry;
 
-	entry->type = type;
-	entry->highlight = highlight;
-	strcpy(entry->name, name);
+	if (!entries) {
+		entries = g_array_new(FALSE, FALSE, sizeof(Entry));
+		names = g_string_chunk_new(1024);
+	}
+
+	entry.type = type;
+	entry.highlight = highlight;
+	entry.name = g_string_chunk_insert_len(names, name, name_len);
 
 	longest = MAX(longest, (gint)name_len);
-	length++;
 
-	/*
-	 * Entries are added in reverse (constant time for GSList),
-	 * so they will later have to be reversed.
-	 */
-	list = g_slist_prepend(list, entry);
+	g_array_append_val(entries, entry);
 }
 
+/**
+ * Render a single page of entries into the popup window.
+ * Only the visible entries are formatted, so this does
+ * not depend on the total number of entries.
+ *
+ * @param page_lines Number of entry lines to render.
+ * @param cols Width of the popup window.
+ * @param entry_cols Number of entry columns.
+ * @param colwidth Width per entry column.
+ */
 void
-CursesInfoPopup::init_pad(attr_t attr)
+CursesInfoPopup::draw_page(gint page_lines, gint cols,
+                           gint entry_cols, gint colwidth)
 {
-	int cols = getmaxx(stdscr);	/* screen width */
-	int pad_lines;			/* pad height */
-	gint pad_cols;			/* entry columns */
-	gint pad_colwidth;		/* width per entry column */
-
-	gint cur_col;
-
-	/* reserve 2 spaces between columns */
-	pad_colwidth = MIN(longest + 2, cols - 2);
-
-	/* pad_cols = floor((cols - 2) / pad_colwidth) */
-	pad_cols = (cols - 2) / pad_colwidth;
-	/* pad_lines = ceil(length / pad_cols) */
-	pad_lines = (length+pad_cols-1) / pad_cols;
-
-	/*
-	 * Render the entire autocompletion list into a pad
-	 * which can be higher than the physical screen.
-	 * The pad uses two columns less than the screen since
-	 * it will be drawn into the popup window which has left
-	 * and right borders.
-	 */
-	pad = newpad(pad_lines, cols - 2);
-
-	wbkgd(pad, ' ' | attr);
-
-	/*
-	 * cur_col is the row currently written.
-	 * It does not wrap but grows indefinitely.
-	 * Therefore the real current row is (cur_col % popup_cols)
-	 */
-	cur_col = 0;
-	for (GSList *cur = list; cur != NULL; cur = g_slist_next(cur)) {
-		Entry *entry = (Entry *)cur->data;
-		gint cur_line = cur_col/pad_cols + 1;
-
-		wmove(pad, cur_line-1,
-		      (cur_col % pad_cols)*pad_colwidth);
-
-		wattrset(pad, entry->highlight ? A_BOLD : A_NORMAL);
-
-		switch (entry->type) {
-		case POPUP_FILE:
-		case POPUP_DIRECTORY:
-			Curses::format_filename(pad, entry->name);
-			break;
-		default:
-			Curses::format_str(pad, entry->name);
-			break;
+	for (gint y = 0; y < page_lines; y++) {
+		for (gint x = 0; x < entry_cols; x++) {
+			guint i = (first_line + y)*entry_cols + x;
+			/* the left border takes one column */
+			gint entry_x = 1 + x*colwidth;
+			Entry *entry;
+
+			if (i >= entries->len)
+				return;
+			entry = &g_array_index(entries, Entry, i);
+
+			/*
+			 * The right border also takes one column.
+			 * The scrollbar may overwrite it.
+			 */
+			wmove(window, y+1, entry_x);
+			wattrset(window, entry->highlight ? A_BOLD : A_NORMAL);
+
+			switch (entry->type) {
+			case POPUP_FILE:
+			case POPUP_DIRECTORY:
+				Curses::format_filename(window, entry->name,
+				                        cols - 1 - entry_x);
+				break;
+			default:
+				Curses::format_str(window, entry->name, -1,
+				                   cols - 1 - entry_x);
+				break;
+			}
 		}
-
-		cur_col++;
 	}
 }
 
@@ -113,11 +102,13 @@ void
 CursesInfoPopup::show(attr_t attr)
 {
 	int lines, cols; /* screen dimensions */
-	gint pad_lines;
+	gint entry_lines;	/* total number of entry lines */
+	gint entry_cols;	/* entry columns */
+	gint colwidth;		/* width per entry column */
 	gint popup_lines;
 	gint bar_height, bar_y;
 
-	if (!length)
+	if (!entries || !entries->len)
 		/* nothing to display */
 		return;
 
@@ -125,24 +116,25 @@ CursesInfoPopup::show(attr_t attr)
 
 	if (window)
 		delwin(window);
-	else
-		/* reverse list only once */
-		list = g_slist_reverse(list);
 
-	if (!pad)
-		init_pad(attr);
-	pad_lines = getmaxy(pad);
+	/* reserve 2 spaces between columns */
+	colwidth = MIN(longest + 2, cols - 2);
+
+	/* entry_cols = floor((cols - 2) / colwidth) */
+	entry_cols = (cols - 2) / colwidth;
+	/* entry_lines = ceil(length / entry_cols) */
+	entry_lines = (entries->len+entry_cols-1) / entry_cols;
 
 	/*
 	 * Popup window can cover all but one screen row.
 	 * Another row is reserved for the top border.
 	 */
-	popup_lines = MIN(pad_lines + 1, lines - 1);
+	popup_lines = MIN(entry_lines + 1, lines - 1);
 
 	/* window covers message, scintilla and info windows */
 	window = newwin(popup_lines, 0, lines - 1 - popup_lines, 0);
 
-	wbkgdset(window, ' ' | attr);
+	wbkgd(window, ' ' | attr);
 
 	wborder(window,
 	        ACS_VLINE,
@@ -152,19 +144,18 @@ CursesInfoPopup::show(attr_t attr)
 	        ACS_ULCORNER, ACS_URCORNER,
 	        ACS_VLINE, ACS_VLINE);
 
-	copywin(pad, window,
-	        pad_first_line, 0,
-	        1, 1, popup_lines - 1, cols - 2, FALSE);
+	draw_page(popup_lines - 1, cols, entry_cols, colwidth);
+	wattrset(window, A_NORMAL);
 
-	if (pad_lines <= popup_lines - 1)
+	if (entry_lines <= popup_lines - 1)
 		/* no need for scrollbar */
 		return;
 
-	/* bar_height = ceil((popup_lines-1)/pad_lines * (popup_lines-2)) */
-	bar_height = ((popup_lines-1)*(popup_lines-2) + pad_lines-1) /
-	             pad_lines;
-	/* bar_y = floor(pad_first_line/pad_lines * (popup_lines-2)) + 1 */
-	bar_y = pad_first_line*(popup_lines-2) / pad_lines + 1;
+	/* bar_height = ceil((popup_lines-1)/entry_lines * (popup_lines-2)) */
+	bar_height = ((popup_lines-1)*(popup_lines-2) + entry_lines-1) /
+	             entry_lines;
+	/* bar_y = floor(first_line/entry_lines * (popup_lines-2)) + 1 */
+	bar_y = first_line*(popup_lines-2) / entry_lines + 1;
 
 	mvwvline(window, 1, cols-1, ACS_CKBOARD, popup_lines-2);
 	/*
@@ -177,43 +168,41 @@ CursesInfoPopup::show(attr_t attr)
 	wvline(window, ' ', bar_height);
 
 	/* progress scroll position */
-	pad_first_line += popup_lines - 1;
+	first_line += popup_lines - 1;
 	/* wrap on last shown page */
-	pad_first_line %= pad_lines;
-	if (pad_lines - pad_first_line < popup_lines - 1)
+	first_line %= entry_lines;
+	if (entry_lines - first_line < popup_lines - 1)
 		/* show last page */
-		pad_first_line = pad_lines - (popup_lines - 1);
+		first_line = entry_lines - (popup_lines - 1);
 }
 
 void
 CursesInfoPopup::clear(void)
 {
-	g_slist_free_full(list, g_free);
-	list = NULL;
-	length = 0;
+	if (entries) {
+		g_array_free(entries, TRUE);
+		entries = NULL;
+		g_string_chunk_free(names);
+		names = NULL;
+	}
 	longest = 0;
 
-	pad_first_line = 0;
+	first_line = 0;
 
 	if (window) {
 		delwin(window);
 		window = NULL;
 	}
-
-	if (pad) {
-		delwin(pad);
-		pad = NULL;
-	}
 }
 
 CursesInfoPopup::~CursesInfoPopup()
 {
 	if (window)
 		delwin(window);
-	if (pad)
-		delwin(pad);
-	if (list)
-		g_slist_free_full(list, g_free);
+	if (entries) {
+		g_array_free(entries, TRUE);
+		g_string_chunk_free(names);
+	}
 }
 
 } /* namespace SciTECO */
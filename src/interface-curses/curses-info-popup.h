@@ -41,25 +41,24 @@ public:
         };
 
 private:
-	WINDOW *window;		/**! window showing part of pad */
-	WINDOW *pad;		/**! full-height entry list */
+	WINDOW *window;		/**! window showing a page of entries */
 
 	struct Entry {
 		PopupEntryType type;
 		bool highlight;
-		gchar name[];
+		const gchar *name;
 	};
 
-	GSList *list;		/**! list of popup entries */
+	GArray *entries;	/**! array of popup entries (Entry) */
+	GStringChunk *names;	/**! storage of all entry names */
 	gint longest;		/**! size of longest entry */
-	gint length;		/**! total number of popup entries */
 
-	gint pad_first_line;	/**! first line in pad to show */
+	gint first_line;	/**! first entry line to show */
 
 public:
-	CursesInfoPopup() : window(NULL), pad(NULL),
-	                    list(NULL), longest(0), length(0),
-	                    pad_first_line(0) {}
+	CursesInfoPopup() : window(NULL),
+	                    entries(NULL), names(NULL), longest(0),
+	                    first_line(0) {}
 
 	void add(PopupEntryType type,
 		 const gchar *name, bool highlight = false);
@@ -83,7 +82,8 @@ public:
 	~CursesInfoPopup();
 
 private:
-	void init_pad(attr_t attr);
+	void draw_page(gint page_lines, gint cols,
+	               gint entry_cols, gint colwidth);
 };
 
 } /* namespace SciTECO */
@@ -22,10 +22,30 @@
 
 #include <curses.h>
 
+#include "sciteco.h"
+
 namespace SciTECO {
 
 namespace Curses {
 
+/**
+ * Get the number of cells a character occupies
+ * when formatted with format_str().
+ */
+static inline gint
+format_width(gchar chr)
+{
+	switch (chr) {
+	case CTL_KEY_ESC:
+		return 1;
+	case '\t':
+		return 3;
+	default:
+		/* includes CR and LF */
+		return IS_CTL(chr) ? 2 : 1;
+	}
+}
+
 gsize format_str(WINDOW *win, const gchar *str,
                  gssize len = -1, gint max_width = -1);
 
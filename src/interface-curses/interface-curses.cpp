@@ -43,6 +43,7 @@
 #endif
 
 #include <Scintilla.h>
+#include <SciLexer.h>
 #include <ScintillaTerm.h>
 
 #ifdef EMSCRIPTEN
@@ -303,6 +304,46 @@ ViewCurses::initialize_impl(void)
 	setup();
 }
 
+/**
+ * Check whether the entire document has been styled.
+ * Documents without a lexer do not need any
+ * background styling.
+ */
+bool
+ViewCurses::is_styled(void)
+{
+	sptr_t lexer = ssm(SCI_GETLEXER);
+
+	return lexer == SCLEX_NULL || lexer == SCLEX_CONTAINER ||
+	       ssm(SCI_GETENDSTYLED) >= ssm(SCI_GETLENGTH);
+}
+
+/**
+ * Style the next chunk of the document after the
+ * styled region.
+ * Scinterm does not support Scintilla's idle styling,
+ * so this is performed by the event loop while no
+ * key is pending.
+ * The visible lines are always styled when the view is
+ * drawn, so background styling only avoids blocking
+ * when the cursor is moved far behind them.
+ *
+ * @return False if the styled region did not grow,
+ *         so background styling must be stopped.
+ */
+bool
+ViewCurses::style_step(void)
+{
+	/* small enough not to delay the processing of keys */
+	static const sptr_t chunk_size = 32*1024;
+
+	sptr_t start = ssm(SCI_GETENDSTYLED);
+	sptr_t end = MIN(start + chunk_size, ssm(SCI_GETLENGTH));
+
+	ssm(SCI_COLOURISE, start, end);
+	return ssm(SCI_GETENDSTYLED) > start;
+}
+
 InterfaceCurses::InterfaceCurses() : stdout_orig(-1), stderr_orig(-1),
                                      screen(NULL),
                                      screen_tty(NULL),
@@ -311,7 +352,13 @@ InterfaceCurses::InterfaceCurses() : stdout_orig(-1), stderr_orig(-1),
                                      info_current(NULL),
                                      msg_window(NULL),
                                      cmdline_window(NULL), cmdline_pad(NULL),
-                                     cmdline_len(0), cmdline_rubout_len(0)
+                                     cmdline_len(0), cmdline_rubout_len(0),
+                                     cmdline_shown(g_string_new(NULL)),
+                                     cmdline_shown_len(0),
+                                     cmdline_cols(g_array_new(FALSE, FALSE,
+                                                              sizeof(guint))),
+                                     cmdline_pad_offset(0),
+                                     cmdline_color(-1)
 {
 	for (guint i = 0; i < G_N_ELEMENTS(color_table); i++)
 		color_table[i] = -1;
@@ -961,31 +1008,128 @@ InterfaceCurses::info_update_impl(const Buffer *buffer)
 	/* NOTE: drawn in event_loop_iter() */
 }
 
+/*
+ * NOTE: Curses dimensions are limited to shorts.
+ * Wider command lines are only partially formatted
+ * into the pad.
+ */
+#define CMDLINE_PAD_MAX G_MAXSHORT
+
+/**
+ * Make sure the command line pad has at least `cols` columns,
+ * but no more than CMDLINE_PAD_MAX.
+ * The pad is grown geometrically.
+ *
+ * @return True if a new pad had to be allocated,
+ *         i.e. the entire command line must be reformatted.
+ */
+bool
+InterfaceCurses::resize_cmdline_pad(gint cols)
+{
+	cols = MIN(cols, CMDLINE_PAD_MAX);
+
+	if (cmdline_pad) {
+		if (getmaxx(cmdline_pad) >= cols)
+			return false;
+		cols = MAX(cols, MIN(getmaxx(cmdline_pad)*2, CMDLINE_PAD_MAX));
+		delwin(cmdline_pad);
+	}
+
+	cmdline_pad = newpad(1, cols);
+	return true;
+}
+
 void
 InterfaceCurses::cmdline_update_impl(const Cmdline *cmdline)
 {
-	short fg, bg;
-	int max_cols = 1;
+	short fg, bg, color;
+	gsize total_len = cmdline->len+cmdline->rubout_len;
+	/* first character that has to be reformatted */
+	gsize start = 0;
+
+	fg = rgb2curses(ssm(SCI_STYLEGETFORE, STYLE_DEFAULT));
+	bg = rgb2curses(ssm(SCI_STYLEGETBACK, STYLE_DEFAULT));
+	color = SCI_COLOR_PAIR(fg, bg);
 
 	/*
-	 * Replace entire pre-formatted command-line.
-	 * We don't know if it is similar to the last one,
-	 * so resizing makes no sense.
-	 * We approximate the size of the new formatted command-line,
-	 * wasting a few bytes for control characters.
+	 * Only the part of the command line that changed since
+	 * the last update is reformatted, so the cost of an update
+	 * does not depend on the length of the command line.
+	 * The command line itself knows where it changed.
+	 * Everything after the effective command line
+	 * is always reformatted since its attributes
+	 * might have changed.
 	 */
-	if (cmdline_pad)
-		delwin(cmdline_pad);
-	for (guint i = 0; i < cmdline->len+cmdline->rubout_len; i++)
-		max_cols += IS_CTL((*cmdline)[i]) ? 3 : 1;
-	cmdline_pad = newpad(1, max_cols);
+	if (color == cmdline_color)
+		start = MIN(MIN(cmdline->changed_pos, cmdline_shown->len),
+		            MIN(cmdline_shown_len, cmdline->len));
+	cmdline_color = color;
+
+	g_array_set_size(cmdline_cols, total_len+1);
+	g_array_index(cmdline_cols, guint, 0) = 0;
+	for (gsize i = start; i < total_len; i++)
+		g_array_index(cmdline_cols, guint, i+1) =
+			g_array_index(cmdline_cols, guint, i) +
+			Curses::format_width((*cmdline)[i]);
 
-	fg = rgb2curses(ssm(SCI_STYLEGETFORE, STYLE_DEFAULT));
-	bg = rgb2curses(ssm(SCI_STYLEGETBACK, STYLE_DEFAULT));
-	wcolor_set(cmdline_pad, SCI_COLOR_PAIR(fg, bg), NULL);
+	/*
+	 * If the command line is too wide for the pad,
+	 * only the part around the end of the effective command line
+	 * is formatted.
+	 * The offset is changed in large steps, so the command line
+	 * rarely has to be reformatted entirely.
+	 */
+	guint pad_offset = 0;
+	gsize first = 0;
+	/* there must be one more column for the cursor */
+	guint total_cols = g_array_index(cmdline_cols, guint, total_len)+1;
+
+	if (total_cols > CMDLINE_PAD_MAX) {
+		guint len_cols = g_array_index(cmdline_cols, guint, cmdline->len);
+		guint step = CMDLINE_PAD_MAX/4;
+		gsize last = cmdline->len;
+
+		if (len_cols > CMDLINE_PAD_MAX/2)
+			pad_offset = (len_cols - CMDLINE_PAD_MAX/2)/step*step;
+
+		/* first character beginning at or after pad_offset */
+		while (first < last) {
+			gsize mid = first + (last - first)/2;
+
+			if (g_array_index(cmdline_cols, guint, mid) < pad_offset)
+				first = mid+1;
+			else
+				last = mid;
+		}
+		pad_offset = g_array_index(cmdline_cols, guint, first);
+	}
+
+	if (resize_cmdline_pad(total_cols - pad_offset) ||
+	    pad_offset != cmdline_pad_offset)
+		start = 0;
+	cmdline_pad_offset = pad_offset;
+	start = MAX(start, first);
+
+	g_string_truncate(cmdline_shown, start);
+	g_string_append_len(cmdline_shown, cmdline->str + start,
+	                    total_len - start);
+	cmdline_shown_len = cmdline->len;
+
+	/*
+	 * NOTE: Stale contents after the end of the command line
+	 * do not have to be erased since draw_cmdline() never
+	 * displays them.
+	 */
+	wmove(cmdline_pad, 0,
+	      g_array_index(cmdline_cols, guint, start) - cmdline_pad_offset);
+	wattrset(cmdline_pad, A_NORMAL);
+	wcolor_set(cmdline_pad, color, NULL);
 
 	/* format effective command line */
-	cmdline_len = Curses::format_str(cmdline_pad, cmdline->str, cmdline->len);
+	if (start < cmdline->len)
+		Curses::format_str(cmdline_pad, cmdline->str + start,
+		                   cmdline->len - start);
+	cmdline_len = g_array_index(cmdline_cols, guint, cmdline->len);
 
 	/*
 	 * A_BOLD should result in either a bold font or a brighter
@@ -1001,18 +1145,22 @@ InterfaceCurses::cmdline_update_impl(const Cmdline *cmdline)
 
 	/*
 	 * Format rubbed-out command line.
-	 * NOTE: This formatting will never be truncated since we're
-	 * writing into the pad which is large enough.
+	 * NOTE: This formatting is only truncated if the command
+	 * line is wider than CMDLINE_PAD_MAX.
 	 */
-	cmdline_rubout_len = Curses::format_str(cmdline_pad, cmdline->str + cmdline->len,
-	                                        cmdline->rubout_len);
+	start = MAX(start, cmdline->len);
+	if (start < total_len)
+		Curses::format_str(cmdline_pad, cmdline->str + start,
+		                   total_len - start);
+	cmdline_rubout_len = g_array_index(cmdline_cols, guint, total_len) -
+	                     cmdline_len;
 
 	/* highlight cursor after effective command line */
 	if (cmdline_rubout_len) {
 		attr_t attr;
 		short pair;
 
-		wmove(cmdline_pad, 0, cmdline_len);
+		wmove(cmdline_pad, 0, cmdline_len - cmdline_pad_offset);
 		wattr_get(cmdline_pad, &attr, &pair, NULL);
 		wchgat(cmdline_pad, 1,
 		       (attr & A_UNDERLINE) | A_REVERSE, pair, NULL);
@@ -1044,6 +1192,9 @@ InterfaceCurses::draw_cmdline(void)
 	 * larger than the text the pad contains.
 	 */
 	disp_len = MIN(total_width, cmdline_len+cmdline_rubout_len - disp_offset);
+	/* the pad may contain only a part of the command line */
+	disp_offset = MAX(disp_offset, cmdline_pad_offset) - cmdline_pad_offset;
+	disp_len = MIN(disp_len, (guint)getmaxx(cmdline_pad) - disp_offset);
 
 	fg = rgb2curses(ssm(SCI_STYLEGETFORE, STYLE_DEFAULT));
 	bg = rgb2curses(ssm(SCI_STYLEGETBACK, STYLE_DEFAULT));
@@ -1055,6 +1206,45 @@ InterfaceCurses::draw_cmdline(void)
 	        0, disp_offset, 0, 1, 0, disp_len, FALSE);
 }
 
+/**
+ * Update the screen while executing long-running
+ * commands.
+ * This is rate-limited by Interface::progress_poll().
+ *
+ * @param elapsed Microseconds since the keypress that
+ *                started execution.
+ */
+void
+InterfaceCurses::draw_progress(gint64 elapsed)
+{
+	gchar elapsed_str[32];
+
+	if (!info_window) /* batch mode */
+		return;
+
+	/*
+	 * The elapsed time is shown at the end of the info line.
+	 * It is overwritten when the info line is redrawn
+	 * after execution.
+	 */
+	draw_info();
+	g_snprintf(elapsed_str, sizeof(elapsed_str), " [%.1fs]",
+	           (gdouble)elapsed / G_USEC_PER_SEC);
+	mvwaddstr(info_window, 0,
+	          MAX(getmaxx(info_window) - (gint)strlen(elapsed_str), 0),
+	          elapsed_str);
+
+	/* the command line may have changed since the last keypress */
+	cmdline_update_impl(&cmdline);
+
+	wnoutrefresh(info_window);
+	current_view->noutrefresh();
+	wnoutrefresh(msg_window);
+	wnoutrefresh(cmdline_window);
+	popup.noutrefresh();
+	doupdate();
+}
+
 #ifdef __PDCURSES__
 
 /*
@@ -1374,6 +1564,26 @@ InterfaceCurses::popup_clear_impl(void)
 	popup.clear();
 }
 
+/*
+ * Maximum number of pending keys processed before
+ * the screen is updated, so continuous input still
+ * results in screen updates.
+ */
+#define TYPEAHEAD_MAX 1024
+
+/**
+ * Pass the keys collected by event_loop_iter() to the
+ * command line at once, so it is refreshed only once.
+ */
+static inline void
+flush_keys(gchar *keys, gsize &keys_len)
+{
+	if (keys_len) {
+		cmdline.keypress(keys, keys_len);
+		keys_len = 0;
+	}
+}
+
 /**
  * One iteration of the event loop.
  *
@@ -1389,6 +1599,10 @@ void
 event_loop_iter()
 {
 	int key;
+	guint keys;
+	/* keys that have not yet been passed to the command line */
+	gchar pending[TYPEAHEAD_MAX];
+	gsize pending_len = 0;
 
 	/*
 	 * On PDCurses/win32, raw() and cbreak() does
@@ -1404,99 +1618,163 @@ event_loop_iter()
 	GetConsoleMode(console_hnd, &console_mode);
 #endif
 
+#ifndef EMSCRIPTEN
 	/*
-	 * Setting function key processing is important
-	 * on Unix Curses, as ESCAPE is handled as the beginning
-	 * of a escape sequence when terminal emulators are
-	 * involved.
-	 * On some Curses variants (XCurses) however, keypad
-	 * must always be TRUE so we receive KEY_RESIZE.
-	 *
-	 * FIXME: NetBSD's curses could be handled like ncurses,
-	 * but gets into an undefined state when SciTECO processes
-	 * escape sequences.
+	 * While the current document has not been styled
+	 * completely, it is styled in the background until
+	 * a key is pending.
+	 * The terminal modes are set up only once for the
+	 * entire styling phase.
+	 * The pending key is pushed back, so it is read
+	 * again below.
 	 */
+	if (!interface.current_view->is_styled()) {
+#ifdef NCURSES_UNIX
+		keypad(interface.cmdline_window, Flags::ed & Flags::ED_FNKEYS);
+#endif
+		nodelay(interface.cmdline_window, TRUE);
+		raw();
+#ifdef PDCURSES_WIN32
+		SetConsoleMode(console_hnd, console_mode & ~ENABLE_PROCESSED_INPUT);
+#endif
+		do {
+			key = wgetch(interface.cmdline_window);
+			if (key != ERR) {
+				ungetch(key);
+				break;
+			}
+		} while (interface.current_view->style_step() &&
+		         !interface.current_view->is_styled());
+		noraw(); /* FIXME: necessary because of NCURSES_WIN32 bug */
+		cbreak();
+#ifdef PDCURSES_WIN32
+		SetConsoleMode(console_hnd, console_mode | ENABLE_PROCESSED_INPUT);
+#endif
+		nodelay(interface.cmdline_window, FALSE);
+	}
+#endif
+
+	/*
+	 * All pending keys (typeahead) are processed before
+	 * the screen is updated, so pasting into the terminal
+	 * or typing fast over slow connections does not result in
+	 * one screen update per key.
+	 * Only the first key is waited for.
+	 * Consecutive keys that are not function keys are passed to
+	 * the command line at once, so e.g. incremental searches
+	 * are not updated for every pasted character.
+	 */
+	for (keys = 0; keys < TYPEAHEAD_MAX;) {
+		/*
+		 * Setting function key processing is important
+		 * on Unix Curses, as ESCAPE is handled as the beginning
+		 * of a escape sequence when terminal emulators are
+		 * involved.
+		 * On some Curses variants (XCurses) however, keypad
+		 * must always be TRUE so we receive KEY_RESIZE.
+		 *
+		 * FIXME: NetBSD's curses could be handled like ncurses,
+		 * but gets into an undefined state when SciTECO processes
+		 * escape sequences.
+		 */
 #ifdef NCURSES_UNIX
-	keypad(interface.cmdline_window, Flags::ed & Flags::ED_FNKEYS);
+		keypad(interface.cmdline_window, Flags::ed & Flags::ED_FNKEYS);
 #endif
 
-	/* no special <CTRL/C> handling */
-	raw();
+		/* no special <CTRL/C> handling */
+		raw();
 #ifdef PDCURSES_WIN32
-	SetConsoleMode(console_hnd, console_mode & ~ENABLE_PROCESSED_INPUT);
+		SetConsoleMode(console_hnd, console_mode & ~ENABLE_PROCESSED_INPUT);
 #endif
-	key = wgetch(interface.cmdline_window);
-	/* allow asynchronous interruptions on <CTRL/C> */
-	sigint_occurred = FALSE;
-	noraw(); /* FIXME: necessary because of NCURSES_WIN32 bug */
-	cbreak();
+		key = wgetch(interface.cmdline_window);
+		/* allow asynchronous interruptions on <CTRL/C> */
+		sigint_occurred = FALSE;
+		noraw(); /* FIXME: necessary because of NCURSES_WIN32 bug */
+		cbreak();
 #ifdef PDCURSES_WIN32
-	SetConsoleMode(console_hnd, console_mode | ENABLE_PROCESSED_INPUT);
+		SetConsoleMode(console_hnd, console_mode | ENABLE_PROCESSED_INPUT);
 #endif
-	if (key == ERR)
-		return;
+		if (key == ERR)
+			break;
 
-	switch (key) {
+		switch (key) {
 #ifdef KEY_RESIZE
-	case KEY_RESIZE:
+		case KEY_RESIZE:
+			flush_keys(pending, pending_len);
 #if PDCURSES
-		resize_term(0, 0);
+			resize_term(0, 0);
 #endif
-		interface.resize_all_windows();
-		break;
+			interface.resize_all_windows();
+			break;
 #endif
-	case CTL_KEY('H'):
-	case 0x7F: /* ^? */
-	case KEY_BACKSPACE:
+		case CTL_KEY('H'):
+		case 0x7F: /* ^? */
+		case KEY_BACKSPACE:
+			/*
+			 * For historic reasons terminals can send
+			 * ASCII 8 (^H) or 127 (^?) for backspace.
+			 * Curses also defines KEY_BACKSPACE, probably
+			 * for terminals that send an escape sequence for
+			 * backspace.
+			 * In SciTECO backspace is normalized to ^H.
+			 */
+			pending[pending_len++] = CTL_KEY('H');
+			break;
+		case KEY_ENTER:
+		case '\r':
+		case '\n':
+			pending[pending_len++] = '\n';
+			break;
+
 		/*
-		 * For historic reasons terminals can send
-		 * ASCII 8 (^H) or 127 (^?) for backspace.
-		 * Curses also defines KEY_BACKSPACE, probably
-		 * for terminals that send an escape sequence for
-		 * backspace.
-		 * In SciTECO backspace is normalized to ^H.
+		 * Function key macros
 		 */
-		cmdline.keypress(CTL_KEY('H'));
-		break;
-	case KEY_ENTER:
-	case '\r':
-	case '\n':
-		cmdline.keypress('\n');
-		break;
-
-	/*
-	 * Function key macros
-	 */
-#define FN(KEY) case KEY_##KEY: cmdline.fnmacro(#KEY); break
+#define FN(KEY) \
+	case KEY_##KEY: \
+		flush_keys(pending, pending_len); \
+		cmdline.fnmacro(#KEY); \
+		break
 #define FNS(KEY) FN(KEY); FN(S##KEY)
-	FN(DOWN); FN(UP); FNS(LEFT); FNS(RIGHT);
-	FNS(HOME);
-	case KEY_F(0)...KEY_F(63): {
-		gchar macro_name[3+1];
-
-		g_snprintf(macro_name, sizeof(macro_name),
-			   "F%d", key - KEY_F0);
-		cmdline.fnmacro(macro_name);
-		break;
-	}
-	FNS(DC);
-	FNS(IC);
-	FN(NPAGE); FN(PPAGE);
-	FNS(PRINT);
-	FN(A1); FN(A3); FN(B2); FN(C1); FN(C3);
-	FNS(END);
-	FNS(HELP);
-	FN(CLOSE);
+		FN(DOWN); FN(UP); FNS(LEFT); FNS(RIGHT);
+		FNS(HOME);
+		case KEY_F(0)...KEY_F(63): {
+			gchar macro_name[3+1];
+
+			g_snprintf(macro_name, sizeof(macro_name),
+				   "F%d", key - KEY_F0);
+			flush_keys(pending, pending_len);
+			cmdline.fnmacro(macro_name);
+			break;
+		}
+		FNS(DC);
+		FNS(IC);
+		FN(NPAGE); FN(PPAGE);
+		FNS(PRINT);
+		FN(A1); FN(A3); FN(B2); FN(C1); FN(C3);
+		FNS(END);
+		FNS(HELP);
+		FN(CLOSE);
 #undef FNS
 #undef FN
 
-	/*
-	 * Control keys and keys with printable representation
-	 */
-	default:
-		if (key <= 0xFF)
-			cmdline.keypress((gchar)key);
+		/*
+		 * Control keys and keys with printable representation
+		 */
+		default:
+			if (key <= 0xFF)
+				pending[pending_len++] = (gchar)key;
+		}
+
+		keys++;
+		nodelay(interface.cmdline_window, TRUE);
 	}
+#ifndef EMSCRIPTEN
+	nodelay(interface.cmdline_window, FALSE);
+#endif
+	if (!keys)
+		return;
+
+	flush_keys(pending, pending_len);
 
 	/*
 	 * Info window is updated very often which is very
@@ -1567,6 +1845,8 @@ InterfaceCurses::~InterfaceCurses()
 		delwin(cmdline_window);
 	if (cmdline_pad)
 		delwin(cmdline_pad);
+	g_string_free(cmdline_shown, TRUE);
+	g_array_free(cmdline_cols, TRUE);
 	if (msg_window)
 		delwin(msg_window);
 
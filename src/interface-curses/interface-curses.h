@@ -41,6 +41,9 @@ public:
 	/* implementation of View::initialize() */
 	void initialize_impl(void);
 
+	bool is_styled(void);
+	bool style_step(void);
+
 	inline ~ViewCurses()
 	{
 		/*
@@ -114,6 +117,23 @@ typedef class InterfaceCurses : public Interface<InterfaceCurses, ViewCurses> {
 
 	WINDOW *cmdline_window, *cmdline_pad;
 	gsize cmdline_len, cmdline_rubout_len;
+	/**
+	 * The command line as it was last formatted into
+	 * cmdline_pad, so only changed parts are reformatted.
+	 */
+	GString *cmdline_shown;
+	/** Effective command line length last formatted */
+	gsize cmdline_shown_len;
+	/** Column of every formatted character (plus the end) */
+	GArray *cmdline_cols;
+	/**
+	 * Column of the command line at the beginning of cmdline_pad.
+	 * This is only non-zero if the command line is wider
+	 * than the largest possible pad.
+	 */
+	guint cmdline_pad_offset;
+	/** Color pair of the formatted command line */
+	short cmdline_color;
 
 	CursesInfoPopup popup;
 
@@ -142,6 +162,9 @@ public:
 	/* implementation of Interface::cmdline_update() */
 	void cmdline_update_impl(const Cmdline *cmdline);
 
+	/* override of Interface::draw_progress() */
+	void draw_progress(gint64 elapsed);
+
 	/* override of Interface::set_clipboard() */
 	void set_clipboard(const gchar *name,
 	                   const gchar *str = NULL, gssize str_len = -1);
@@ -189,6 +212,7 @@ private:
 
 	void set_window_title(const gchar *title);
 	void draw_info(void);
+	bool resize_cmdline_pad(gint cols);
 	void draw_cmdline(void);
 
 	friend void event_loop_iter();
@@ -0,0 +1,451 @@
+/*
+ * Copyright (C) 2012-2017 Robin Haberkorn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Headless Scintilla platform layer.
+ *
+ * This is built into scintilla.a instead of Scinterm
+ * when configuring with --with-interface=null (see scintilla.mk).
+ * Nothing is ever drawn, so all windowing primitives are no-ops.
+ * In particular, there are no surfaces: Scintilla only measures
+ * and paints when it was given a window ID, which we never do.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <assert.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <memory>
+
+#include "Platform.h"
+
+#include "ILexer.h"
+#include "Scintilla.h"
+#include "SciLexer.h"
+#include "LexerModule.h"
+#include "SplitVector.h"
+#include "Partitioning.h"
+#include "RunStyles.h"
+#include "ContractionState.h"
+#include "CellBuffer.h"
+#include "CallTip.h"
+#include "KeyMap.h"
+#include "Indicator.h"
+#include "XPM.h"
+#include "LineMarker.h"
+#include "Style.h"
+#include "AutoComplete.h"
+#include "ViewStyle.h"
+#include "CharClassify.h"
+#include "Decoration.h"
+#include "CaseFolder.h"
+#include "Document.h"
+#include "Selection.h"
+#include "PositionCache.h"
+#include "EditModel.h"
+#include "MarginView.h"
+#include "EditView.h"
+#include "Editor.h"
+#include "ScintillaBase.h"
+
+#include "ScintillaNull.h"
+
+#ifdef SCI_NAMESPACE
+using namespace Scintilla;
+#endif
+
+/*
+ * Fonts
+ */
+
+Font::Font() : fid(0) {}
+
+Font::~Font() {}
+
+void
+Font::Create(const FontParameters &fp)
+{
+	/* dummy non-NULL ID, so Scintilla considers the font valid */
+	fid = reinterpret_cast<FontID>(1);
+}
+
+void
+Font::Release()
+{
+	fid = 0;
+}
+
+/*
+ * Surfaces are only allocated for windows with an ID.
+ * Since the editor window has none, this is never called
+ * for drawing and callers check for NULL.
+ */
+Surface *
+Surface::Allocate(int technology)
+{
+	return NULL;
+}
+
+/*
+ * Windows
+ */
+
+Window::~Window() {}
+
+void
+Window::Destroy()
+{
+	wid = 0;
+}
+
+bool
+Window::HasFocus()
+{
+	return false;
+}
+
+PRectangle
+Window::GetPosition()
+{
+	return PRectangle();
+}
+
+void Window::SetPosition(PRectangle rc) {}
+
+void Window::SetPositionRelative(PRectangle rc, Window relativeTo) {}
+
+PRectangle
+Window::GetClientPosition()
+{
+	return PRectangle();
+}
+
+void Window::Show(bool show) {}
+
+void Window::InvalidateAll() {}
+
+void Window::InvalidateRectangle(PRectangle rc) {}
+
+void Window::SetFont(Font &font) {}
+
+void
+Window::SetCursor(Cursor curs)
+{
+	cursorLast = curs;
+}
+
+void Window::SetTitle(const char *s) {}
+
+PRectangle
+Window::GetMonitorRect(Point pt)
+{
+	return PRectangle();
+}
+
+/*
+ * List boxes are allocated unconditionally by the
+ * autocompletion, so there must be a dummy implementation
+ * that remains empty.
+ */
+class ListBoxNull : public ListBox {
+public:
+	ListBoxNull() {}
+	virtual ~ListBoxNull() {}
+
+	virtual void SetFont(Font &font) {}
+	virtual void Create(Window &parent, int ctrlID, Point location,
+	                    int lineHeight_, bool unicodeMode_,
+	                    int technology_) {}
+	virtual void SetAverageCharWidth(int width) {}
+	virtual void SetVisibleRows(int rows) {}
+	virtual int GetVisibleRows() const { return 0; }
+	virtual PRectangle GetDesiredRect() { return PRectangle(); }
+	virtual int CaretFromEdge() { return 0; }
+	virtual void Clear() {}
+	virtual void Append(char *s, int type = -1) {}
+	virtual int Length() { return 0; }
+	virtual void Select(int n) {}
+	virtual int GetSelection() { return -1; }
+	virtual int Find(const char *prefix) { return -1; }
+	virtual void
+	GetValue(int n, char *value, int len)
+	{
+		if (len > 0)
+			*value = '\0';
+	}
+	virtual void RegisterImage(int type, const char *xpm_data) {}
+	virtual void RegisterRGBAImage(int type, int width, int height,
+	                               const unsigned char *pixelsImage) {}
+	virtual void ClearRegisteredImages() {}
+	virtual void SetDoubleClickAction(CallBackAction action, void *data) {}
+	virtual void SetList(const char *list, char separator, char typesep) {}
+};
+
+ListBox::ListBox() {}
+
+ListBox::~ListBox() {}
+
+ListBox *
+ListBox::Allocate()
+{
+	return new ListBoxNull();
+}
+
+/*
+ * Menus
+ */
+
+Menu::Menu() : mid(0) {}
+
+void Menu::CreatePopUp() {}
+
+void
+Menu::Destroy()
+{
+	mid = 0;
+}
+
+void Menu::Show(Point pt, Window &w) {}
+
+/*
+ * Timing
+ */
+
+ElapsedTime::ElapsedTime()
+{
+	bigBit = clock();
+	littleBit = 0;
+}
+
+double
+ElapsedTime::Duration(bool reset)
+{
+	clock_t now = clock();
+	double duration = (double)(now - bigBit) / CLOCKS_PER_SEC;
+
+	if (reset)
+		bigBit = now;
+	return duration;
+}
+
+/*
+ * External lexers are not supported.
+ */
+DynamicLibrary *
+DynamicLibrary::Load(const char *modulePath)
+{
+	return NULL;
+}
+
+/*
+ * Platform
+ */
+
+ColourDesired
+Platform::Chrome()
+{
+	return ColourDesired(0xC0, 0xC0, 0xC0);
+}
+
+ColourDesired
+Platform::ChromeHighlight()
+{
+	return ColourDesired(0xFF, 0xFF, 0xFF);
+}
+
+const char *
+Platform::DefaultFont()
+{
+	return "monospace";
+}
+
+int
+Platform::DefaultFontSize()
+{
+	return 10;
+}
+
+unsigned int
+Platform::DoubleClickTime()
+{
+	return 500;
+}
+
+bool
+Platform::MouseButtonBounce()
+{
+	return true;
+}
+
+void
+Platform::DebugDisplay(const char *s)
+{
+	fputs(s, stderr);
+}
+
+bool
+Platform::IsKeyDown(int key)
+{
+	return false;
+}
+
+long
+Platform::SendScintilla(WindowID w, unsigned int msg,
+                        unsigned long wParam, long lParam)
+{
+	return 0;
+}
+
+long
+Platform::SendScintillaPointer(WindowID w, unsigned int msg,
+                               unsigned long wParam, void *lParam)
+{
+	return 0;
+}
+
+bool
+Platform::IsDBCSLeadByte(int codePage, char ch)
+{
+	return false;
+}
+
+int
+Platform::DBCSCharLength(int codePage, const char *s)
+{
+	return 1;
+}
+
+int
+Platform::DBCSCharMaxLength()
+{
+	return 1;
+}
+
+int
+Platform::Minimum(int a, int b)
+{
+	return a < b ? a : b;
+}
+
+int
+Platform::Maximum(int a, int b)
+{
+	return a > b ? a : b;
+}
+
+int
+Platform::Clamp(int val, int minVal, int maxVal)
+{
+	return Minimum(Maximum(val, minVal), maxVal);
+}
+
+void
+Platform::DebugPrintf(const char *format, ...)
+{
+#ifdef TRACE
+	va_list ap;
+
+	va_start(ap, format);
+	vfprintf(stderr, format, ap);
+	va_end(ap);
+#endif
+}
+
+static bool assertionPopUps = true;
+
+bool
+Platform::ShowAssertionPopUps(bool assertionPopUps_)
+{
+	bool ret = assertionPopUps;
+	assertionPopUps = assertionPopUps_;
+	return ret;
+}
+
+void
+Platform::Assert(const char *c, const char *file, int line)
+{
+	fprintf(stderr, "Assertion [%s] failed at %s %d\n", c, file, line);
+	abort();
+}
+
+/*
+ * Headless editor.
+ * All notifications are passed on to the callback.
+ */
+class ScintillaNull : public ScintillaBase {
+	void (*callback)(Scintilla *sci, int idFrom,
+	                 void *notify, void *user_data);
+
+public:
+	ScintillaNull(void (*callback_)(Scintilla *, int, void *, void *))
+	             : callback(callback_) {}
+	virtual ~ScintillaNull() {}
+
+	virtual void Initialise() {}
+	virtual void SetVerticalScrollPos() {}
+	virtual void SetHorizontalScrollPos() {}
+	virtual bool ModifyScrollBars(int nMax, int nPage) { return false; }
+	/* there is no clipboard */
+	virtual void Copy() {}
+	virtual void Paste() {}
+	virtual void ClaimSelection() {}
+	virtual void CopyToClipboard(const SelectionText &selectedText) {}
+	virtual void NotifyChange() {}
+	virtual void
+	NotifyParent(SCNotification scn)
+	{
+		if (callback)
+			callback(this, 0, &scn, NULL);
+	}
+	virtual void SetMouseCapture(bool on) {}
+	virtual bool HaveMouseCapture() { return false; }
+	virtual sptr_t
+	DefWndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam)
+	{
+		return 0;
+	}
+	virtual void CreateCallTipWindow(PRectangle rc) {}
+	virtual void AddToPopUp(const char *label, int cmd = 0,
+	                        bool enabled = true) {}
+};
+
+Scintilla *
+scintilla_new(void (*callback)(Scintilla *sci, int idFrom,
+                               void *notify, void *user_data))
+{
+	return new ScintillaNull(callback);
+}
+
+sptr_t
+scintilla_send_message(Scintilla *sci, unsigned int iMessage,
+                       uptr_t wParam, sptr_t lParam)
+{
+	return static_cast<ScintillaNull *>(sci)->WndProc(iMessage, wParam, lParam);
+}
+
+void
+scintilla_delete(Scintilla *sci)
+{
+	delete static_cast<ScintillaNull *>(sci);
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2012-2017 Robin Haberkorn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SCINTILLA_NULL_H
+#define __SCINTILLA_NULL_H
+
+/*
+ * Headless Scintilla platform layer of the null interface.
+ * The API mirrors Scinterm's, so the null interface can use
+ * Scintilla without linking against any curses library.
+ */
+
+#include <Scintilla.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void Scintilla;
+
+Scintilla *scintilla_new(void (*callback)(Scintilla *sci, int idFrom,
+                                          void *notify, void *user_data));
+sptr_t scintilla_send_message(Scintilla *sci, unsigned int iMessage,
+                              uptr_t wParam, sptr_t lParam);
+void scintilla_delete(Scintilla *sci);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2012-2017 Robin Haberkorn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <glib.h>
+
+#include <Scintilla.h>
+
+#include "sciteco.h"
+#include "interface.h"
+#include "interface-null.h"
+#include "ScintillaNull.h"
+
+namespace SciTECO {
+
+static void scintilla_notify(Scintilla *sci, int idFrom,
+                             void *notify, void *user_data);
+
+void
+ViewNull::initialize_impl(void)
+{
+	sci = scintilla_new(scintilla_notify);
+	setup();
+}
+
+void
+InterfaceNull::event_loop_impl(void)
+{
+	/*
+	 * There is no interactive mode.
+	 * Terminate as if the command line had been
+	 * terminated immediately, so the quit hook is
+	 * still executed.
+	 */
+}
+
+static void
+scintilla_notify(Scintilla *sci, int idFrom, void *notify, void *user_data)
+{
+	interface.process_notify((SCNotification *)notify);
+}
+
+} /* namespace SciTECO */
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2012-2017 Robin Haberkorn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __INTERFACE_NULL_H
+#define __INTERFACE_NULL_H
+
+#include <stdarg.h>
+
+#include <glib.h>
+
+#include <Scintilla.h>
+
+#include "ScintillaNull.h"
+
+#include "interface.h"
+
+namespace SciTECO {
+
+/**
+ * View of the headless interface.
+ * Scintilla is built with a headless platform layer
+ * (see ScintillaNull.cxx), so it is never drawn.
+ */
+typedef class ViewNull : public View<ViewNull> {
+	Scintilla *sci;
+
+public:
+	ViewNull() : sci(NULL) {}
+
+	/* implementation of View::initialize() */
+	void initialize_impl(void);
+
+	inline ~ViewNull()
+	{
+		if (sci)
+			scintilla_delete(sci);
+	}
+
+	/* implementation of View::ssm() */
+	inline sptr_t
+	ssm_impl(unsigned int iMessage, uptr_t wParam = 0, sptr_t lParam = 0)
+	{
+		return scintilla_send_message(sci, iMessage, wParam, lParam);
+	}
+} ViewCurrent;
+
+/**
+ * Headless user interface for batch processing.
+ * It does not depend on a terminal or windowing system,
+ * so there is no interactive mode.
+ * Messages are printed to stdout and stderr just like
+ * in the batch mode of the other interfaces.
+ */
+typedef class InterfaceNull : public Interface<InterfaceNull, ViewNull> {
+public:
+	/* implementation of Interface::vmsg() */
+	inline void
+	vmsg_impl(MessageType type, const gchar *fmt, va_list ap)
+	{
+		stdio_vmsg(type, fmt, ap);
+	}
+
+	/* implementation of Interface::show_view() */
+	inline void
+	show_view_impl(ViewNull *view)
+	{
+		current_view = view;
+	}
+
+	/* implementation of Interface::info_update() */
+	inline void info_update_impl(const QRegister *reg) {}
+	inline void info_update_impl(const Buffer *buffer) {}
+
+	/* implementation of Interface::cmdline_update() */
+	inline void cmdline_update_impl(const Cmdline *cmdline) {}
+
+	/* implementation of Interface::popup_add() */
+	inline void
+	popup_add_impl(PopupEntryType type,
+	               const gchar *name, bool highlight = false) {}
+	/* implementation of Interface::popup_show() */
+	inline void popup_show_impl(void) {}
+	/* implementation of Interface::popup_is_shown() */
+	inline bool
+	popup_is_shown_impl(void)
+	{
+		return false;
+	}
+	/* implementation of Interface::popup_clear() */
+	inline void popup_clear_impl(void) {}
+
+	/* main entry point (implementation) */
+	void event_loop_impl(void);
+} InterfaceCurrent;
+
+} /* namespace SciTECO */
+
+#endif
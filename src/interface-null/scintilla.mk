@@ -0,0 +1,43 @@
+# Builds scintilla.a with the headless platform layer
+# (ScintillaNull.cxx) instead of Scinterm.
+# This is used by scintilla.am for the null interface,
+# so it does not depend on any curses library.
+# Requires GNU Make. Object files are written into
+# the current directory.
+
+SCINTILLA_PATH = ../../scintilla
+SCINTILLA_NULL_PATH := $(patsubst %/,%,$(dir $(lastword $(MAKEFILE_LIST))))
+
+CXX = g++
+AR = ar
+RANLIB = ranlib
+CXXFLAGS = -O2
+
+ALL_CXXFLAGS = -DSCI_LEXER \
+               -I$(SCINTILLA_PATH)/include -I$(SCINTILLA_PATH)/src \
+               -I$(SCINTILLA_PATH)/lexlib -I$(SCINTILLA_NULL_PATH) \
+               $(CXXFLAGS)
+
+sources = $(wildcard $(SCINTILLA_PATH)/src/*.cxx) \
+          $(wildcard $(SCINTILLA_PATH)/lexlib/*.cxx) \
+          $(wildcard $(SCINTILLA_PATH)/lexers/*.cxx) \
+          $(SCINTILLA_NULL_PATH)/ScintillaNull.cxx
+objects = $(notdir $(sources:.cxx=.o))
+
+vpath %.cxx $(sort $(dir $(sources)))
+
+scintilla = $(SCINTILLA_PATH)/bin/scintilla.a
+
+all : $(scintilla)
+
+$(scintilla) : $(objects)
+	$(AR) rc $@ $^
+	$(RANLIB) $@
+
+%.o : %.cxx
+	$(CXX) $(ALL_CXXFLAGS) -c $< -o $@
+
+clean :
+	rm -f $(objects) $(scintilla)
+
+.PHONY: all clean
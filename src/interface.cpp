@@ -144,12 +144,16 @@ template <class InterfaceImpl, class ViewImpl>
 void
 Interface<InterfaceImpl, ViewImpl>::stdio_vmsg(MessageType type, const gchar *fmt, va_list ap)
 {
-	FILE *stream = stdout;
+	FILE *stream = stdio_msg_stream;
 
 	switch (type) {
 	case MSG_USER:
+		if (!stream)
+			return;
 		break;
 	case MSG_INFO:
+		if (!stream)
+			return;
 		fputs("Info: ", stream);
 		break;
 	case MSG_WARNING:
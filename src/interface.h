@@ -19,6 +19,7 @@
 #define __INTERFACE_H
 
 #include <stdarg.h>
+#include <stdio.h>
 #include <signal.h>
 
 #include <glib.h>
@@ -29,6 +30,17 @@
 #include "undo.h"
 #include "error.h"
 
+/**
+ * Default maximum number of screen updates per second
+ * while executing long-running commands.
+ */
+#define PROGRESS_RATE_DEFAULT 20
+/**
+ * Number of executed characters between checks of the
+ * monotonic clock for screen updates.
+ */
+#define PROGRESS_CHECK_INTERVAL 1024
+
 namespace SciTECO {
 
 /* avoid include dependency conflict */
@@ -184,8 +196,32 @@ class Interface : public Object {
 protected:
 	ViewImpl *current_view;
 
+	/*
+	 * Timing of screen updates while executing commands
+	 * (monotonic time in microseconds).
+	 */
+	gint64 progress_start, progress_next;
+	guint progress_countdown;
+
 public:
-	Interface() : current_view(NULL) {}
+	/**
+	 * Maximum number of screen updates per second while
+	 * executing commands. 0 disables them.
+	 */
+	guint progress_rate;
+
+	/**
+	 * Stream that user and info messages are printed to
+	 * in batch mode or NULL to suppress them.
+	 * Warnings and errors always go to stderr.
+	 */
+	FILE *stdio_msg_stream;
+
+	Interface() : current_view(NULL),
+	              progress_start(0), progress_next(0),
+	              progress_countdown(PROGRESS_CHECK_INTERVAL),
+	              progress_rate(PROGRESS_RATE_DEFAULT),
+	              stdio_msg_stream(stdout) {}
 
 	/* default implementation */
 	inline GOptionGroup *
@@ -334,6 +370,52 @@ public:
 		return sigint_occurred != FALSE;
 	}
 
+	/**
+	 * Start timing the execution of commands,
+	 * e.g. when processing a keypress.
+	 * The first screen update will take place
+	 * only after one frame has passed.
+	 */
+	inline void
+	progress_begin(void)
+	{
+		progress_start = g_get_monotonic_time();
+		progress_next = progress_rate
+			? progress_start + G_USEC_PER_SEC/progress_rate
+			: G_MAXINT64;
+	}
+
+	/**
+	 * Update the screen if a long-running command is
+	 * being executed.
+	 * This is called for every executed character,
+	 * but the clock is checked only every
+	 * PROGRESS_CHECK_INTERVAL characters and the
+	 * screen is updated at most progress_rate times
+	 * per second.
+	 */
+	inline void
+	progress_poll(void)
+	{
+		gint64 now;
+
+		if (G_LIKELY(--progress_countdown))
+			return;
+		progress_countdown = PROGRESS_CHECK_INTERVAL;
+
+		if (!progress_rate)
+			return;
+		now = g_get_monotonic_time();
+		if (now < progress_next)
+			return;
+		progress_next = now + G_USEC_PER_SEC/progress_rate;
+
+		impl().draw_progress(now - progress_start);
+	}
+
+	/* default implementation */
+	inline void draw_progress(gint64 elapsed) {}
+
 	/* main entry point */
 	inline void
 	event_loop(void)
@@ -356,6 +438,8 @@ public:
 #include "interface-gtk/interface-gtk.h"
 #elif defined(INTERFACE_CURSES)
 #include "interface-curses/interface-curses.h"
+#elif defined(INTERFACE_NULL)
+#include "interface-null/interface-null.h"
 #else
 #error No interface selected!
 #endif
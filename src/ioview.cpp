@@ -286,6 +286,14 @@ make_savepoint(const gchar *filename)
 
 #endif
 
+/**
+ * Write the document to a channel.
+ *
+ * Both halves of Scintilla's gap buffer are written
+ * in place via SCI_GETRANGEPOINTER.
+ * Unlike SCI_GETCHARACTERPOINTER, this never moves
+ * the gap, so the document is not copied at all.
+ */
 void
 IOView::save(GIOChannel *channel)
 {
@@ -312,8 +320,25 @@ IOView::save(GIOChannel *channel)
 	}
 }
 
-void
-IOView::save(const gchar *filename)
+/**
+ * Data source for save_file().
+ */
+class SaveSource : public Object {
+public:
+	virtual ~SaveSource() {}
+
+	virtual void write(GIOChannel *channel) = 0;
+};
+
+/**
+ * Save data to file, creating save points and preserving
+ * file attributes as necessary.
+ *
+ * @param filename File to write.
+ * @param source Writes the data to a buffered and blocking channel.
+ */
+static void
+save_file(const gchar *filename, SaveSource &source)
 {
 	GError *error = NULL;
 	GIOChannel *channel;
@@ -333,7 +358,7 @@ IOView::save(const gchar *filename)
 			attributes = get_file_attributes(filename);
 			make_savepoint(filename);
 		} else {
-			undo.push<UndoTokenRemoveFile>(filename);
+			undo.push<IOView::UndoTokenRemoveFile>(filename);
 		}
 	}
 
@@ -343,14 +368,14 @@ IOView::save(const gchar *filename)
 		throw GlibError(error);
 
 	/*
-	 * save(GIOChannel *, const gchar *) expects a buffered
+	 * SaveSource::write() expects a buffered
 	 * and blocking channel
 	 */
 	g_io_channel_set_encoding(channel, NULL, NULL);
 	g_io_channel_set_buffered(channel, TRUE);
 
 	try {
-		save(channel);
+		source.write(channel);
 	} catch (Error &e) {
 		Error err("Error writing file \"%s\": %s", filename, e.description);
 		g_io_channel_unref(channel);
@@ -378,6 +403,72 @@ IOView::save(const gchar *filename)
 	g_io_channel_unref(channel);
 }
 
+class SaveSourceView : public SaveSource {
+	IOView &view;
+
+public:
+	SaveSourceView(IOView &_view) : view(_view) {}
+
+	void
+	write(GIOChannel *channel)
+	{
+		view.save(channel);
+	}
+};
+
+void
+IOView::save(const gchar *filename)
+{
+	SaveSourceView source(*this);
+
+	save_file(filename, source);
+}
+
+class SaveSourceString : public SaveSource {
+	const gchar *str;
+	gsize str_len;
+	gint eol_mode;
+
+public:
+	SaveSourceString(const gchar *_str, gsize _str_len, gint _eol_mode)
+	                : str(_str), str_len(_str_len), eol_mode(_eol_mode) {}
+
+	void
+	write(GIOChannel *channel)
+	{
+		EOLWriterGIO writer(channel, eol_mode);
+		gsize bytes_written;
+
+		if (!str_len)
+			return;
+
+		bytes_written = writer.convert(str, str_len);
+		g_assert(bytes_written == str_len);
+	}
+};
+
+/**
+ * Save a string to file.
+ *
+ * This has the same semantics as IOView::save(),
+ * i.e. it performs EOL translation and creates save points,
+ * but writes from memory instead of a Scintilla document.
+ *
+ * @param filename File to write.
+ * @param str String to write (not necessarily null-terminated).
+ *            May be NULL if `str_len` is 0.
+ * @param str_len Length of `str`.
+ * @param eol_mode EOL mode to translate to.
+ */
+void
+save_string(const gchar *filename, const gchar *str, gsize str_len,
+            gint eol_mode)
+{
+	SaveSourceString source(str, str_len, eol_mode);
+
+	save_file(filename, source);
+}
+
 /*
  * Auxiliary functions
  */
@@ -75,6 +75,9 @@ normalize_path(gchar *path)
 
 bool file_is_visible(const gchar *path);
 
+void save_string(const gchar *filename, const gchar *str, gsize str_len,
+                 gint eol_mode);
+
 /**
  * This gets the length of a file name's directory
  * component including any trailing directory separator.
@@ -99,6 +102,7 @@ file_get_dirname_len(const gchar *path)
 }
 
 class IOView : public ViewCurrent {
+public:
 	class UndoTokenRemoveFile : public UndoToken {
 		gchar *filename;
 
@@ -117,7 +121,6 @@ class IOView : public ViewCurrent {
 		}
 	};
 
-public:
 	void load(GIOChannel *channel);
 	void load(const gchar *filename);
 
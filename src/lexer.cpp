@@ -0,0 +1,463 @@
+/*
+ * Copyright (C) 2012-2017 Robin Haberkorn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <glib.h>
+
+#include <Scintilla.h>
+
+#include "sciteco.h"
+#include "string-utils.h"
+#include "expressions.h"
+#include "interface.h"
+#include "undo.h"
+#include "qregisters.h"
+#include "ring.h"
+#include "parser.h"
+#include "search.h"
+#include "glob.h"
+#include "error.h"
+#include "lexer.h"
+
+namespace SciTECO {
+
+LexerTable lexer_table;
+StyleBundle *StyleBundle::recording = NULL;
+
+namespace States {
+	StateLexerPattern	lexerpattern;
+	StateLexerMacro		lexermacro;
+}
+
+/** pattern argument of EA, while the macro name is read */
+static gchar *lexer_pattern = NULL;
+
+/**
+ * Record a Scintilla message.
+ *
+ * @param str If non-NULL, the null-terminated string
+ *            passed as lParam, which is copied.
+ *            `lParam` is ignored in this case.
+ */
+void
+StyleBundle::append(unsigned int iMessage, uptr_t wParam,
+                    sptr_t lParam, const gchar *str)
+{
+	Message msg = {iMessage, wParam, lParam, -1};
+
+	if (str) {
+		msg.lParam_offset = strings->len;
+		/* including the null-terminator */
+		g_string_append_len(strings, str, strlen(str)+1);
+	}
+
+	g_array_append_val(messages, msg);
+}
+
+/**
+ * Send all recorded messages to the current view.
+ * The messages' return values are discarded.
+ */
+void
+StyleBundle::replay(void)
+{
+	for (guint i = 0; i < messages->len; i++) {
+		const Message &msg = g_array_index(messages, Message, i);
+		sptr_t lParam = msg.lParam_offset < 0
+				? msg.lParam
+				: (sptr_t)(strings->str + msg.lParam_offset);
+
+		interface.ssm(msg.iMessage, msg.wParam, lParam);
+	}
+}
+
+LexerTable::~LexerTable()
+{
+	Entry *entry;
+
+	while ((entry = TAILQ_FIRST(&head))) {
+		TAILQ_REMOVE(&head, entry, entries);
+		delete entry;
+	}
+}
+
+/**
+ * Add an association.
+ *
+ * @param header Whether `pattern` is a search pattern matched
+ *               against the beginning of the document's first line
+ *               instead of a glob pattern matched against the
+ *               buffer's file name.
+ * @param bundled Whether to record the ES messages sent by
+ *                the macro into a style bundle when it is
+ *                executed for the first time and to replay
+ *                the bundle instead of executing the macro
+ *                later on.
+ * @param pattern The pattern to compile.
+ * @param macro Name of the global Q-Register to execute
+ *              when the pattern matches.
+ */
+void
+LexerTable::add(bool header, bool bundled,
+                const gchar *pattern, const gchar *macro)
+{
+	GRegex *re;
+	Entry *entry;
+
+	re = header ? States::search.compile_pattern(pattern)
+	            : Globber::compile_pattern(pattern);
+	if (!re)
+		throw Error("Invalid pattern \"%s\"", pattern);
+
+	entry = new Entry(header, bundled, re, macro);
+	/* just like Q-Register specifications */
+	if (!entry->macro[1])
+		entry->macro[0] = String::toupper(entry->macro[0]);
+	TAILQ_INSERT_TAIL(&head, entry, entries);
+}
+
+void
+LexerTable::remove_last(void)
+{
+	Entry *entry = TAILQ_LAST(&head, Head);
+
+	TAILQ_REMOVE(&head, entry, entries);
+	delete entry;
+}
+
+/**
+ * Look up the lexer association for the current document.
+ * All patterns are matched in a single pass and the
+ * first line is fetched only if there are header patterns.
+ *
+ * @param macro If non-NULL, only associations with this
+ *              lexer macro are considered.
+ * @return The first matching association or NULL.
+ */
+LexerTable::Entry *
+LexerTable::find(const gchar *macro)
+{
+	const gchar *filename = ring.current->filename ? : "";
+	const gchar *header = NULL;
+	gssize header_len = 0;
+	Entry *entry;
+
+	TAILQ_FOREACH(entry, &head, entries) {
+		if (macro && strcmp(entry->macro, macro))
+			continue;
+
+		if (entry->header) {
+			if (!header) {
+				header_len = interface.ssm(SCI_GETLINEENDPOSITION, 0);
+				header = (const gchar *)
+				         interface.ssm(SCI_GETRANGEPOINTER, 0, header_len);
+			}
+
+			if (!g_regex_match_full(entry->pattern, header, header_len, 0,
+			                        G_REGEX_MATCH_ANCHORED, NULL, NULL))
+				continue;
+		} else if (!g_regex_match(entry->pattern, filename,
+		                          (GRegexMatchFlags)0, NULL)) {
+			continue;
+		}
+
+		return entry;
+	}
+
+	return NULL;
+}
+
+/**
+ * Check whether any association with the given lexer macro
+ * matches the current document.
+ */
+bool
+LexerTable::test(const gchar *macro)
+{
+	gchar *name = g_strdup(macro);
+	bool ret;
+
+	/* just like Q-Register specifications */
+	if (*name && !name[1])
+		*name = String::toupper(*name);
+	ret = find(name) != NULL;
+	g_free(name);
+
+	return ret;
+}
+
+/**
+ * Set up the lexer for the current document by executing
+ * the macro of the first matching association or by
+ * replaying its style bundle.
+ * The macro is executed without creating a new local
+ * Q-Register table.
+ *
+ * @return Whether any association matched.
+ */
+bool
+LexerTable::dispatch(void)
+{
+	Entry *entry = find();
+	QRegister *reg;
+	StyleBundle *parent_recording;
+
+	if (!entry)
+		return false;
+
+	if (entry->bundle) {
+		entry->bundle->replay();
+		return true;
+	}
+
+	reg = QRegisters::globals[entry->macro];
+	if (!reg)
+		throw InvalidQRegError(entry->macro);
+
+	if (!entry->bundled) {
+		reg->execute(false);
+		return true;
+	}
+
+	parent_recording = StyleBundle::recording;
+	StyleBundle::recording = new StyleBundle;
+
+	try {
+		reg->execute(false);
+	} catch (...) {
+		delete StyleBundle::recording;
+		StyleBundle::recording = parent_recording;
+		throw;
+	}
+
+	/*
+	 * NOTE: The macro might have discarded the bundles,
+	 * but associations are only removed when rubbing out,
+	 * so `entry` is still valid.
+	 */
+	delete entry->bundle;
+	entry->bundle = StyleBundle::recording;
+	StyleBundle::recording = parent_recording;
+
+	return true;
+}
+
+/**
+ * Discard all style bundles, so they are recorded again
+ * on the next use of their associations.
+ */
+void
+LexerTable::clear_bundles(void)
+{
+	Entry *entry;
+
+	TAILQ_FOREACH(entry, &head, entries) {
+		delete entry->bundle;
+		entry->bundle = NULL;
+	}
+}
+
+/**
+ * Write all associations into an image.
+ * Since the patterns are saved in their compiled form,
+ * search patterns referring to Q-Registers do not have to
+ * be expanded again.
+ */
+void
+LexerTable::write(SnapshotWriter &writer)
+{
+	guint32 count = 0;
+	Entry *entry;
+
+	TAILQ_FOREACH(entry, &head, entries)
+		count++;
+	writer.write(count);
+
+	TAILQ_FOREACH(entry, &head, entries) {
+		writer.write<guint8>(entry->header | entry->bundled << 1);
+		writer.write<guint32>(g_regex_get_compile_flags(entry->pattern));
+		writer.write_string(g_regex_get_pattern(entry->pattern));
+		writer.write_string(entry->macro);
+	}
+}
+
+/**
+ * Read associations from an image, appending them.
+ *
+ * @param reader The snapshot reader.
+ * @param apply If false, the data is only checked.
+ * @return False if the data is corrupt.
+ */
+bool
+LexerTable::read(SnapshotReader &reader, bool apply)
+{
+	guint32 count;
+
+	if (!reader.read(count))
+		return false;
+
+	while (count--) {
+		guint8 type;
+		guint32 flags;
+		const gchar *pattern_data, *macro_data;
+		gsize pattern_len, macro_len;
+		GRegex *re;
+
+		if (!reader.read(type) || !reader.read(flags))
+			return false;
+		pattern_data = reader.read_string(pattern_len);
+		if (!pattern_data)
+			return false;
+		macro_data = reader.read_string(macro_len);
+		if (!macro_data)
+			return false;
+
+		if (!apply)
+			continue;
+
+		gchar *pattern = g_strndup(pattern_data, pattern_len);
+		re = g_regex_new(pattern, (GRegexCompileFlags)flags,
+		                 (GRegexMatchFlags)0, NULL);
+		g_free(pattern);
+		if (!re)
+			return false;
+
+		gchar *macro = g_strndup(macro_data, macro_len);
+		TAILQ_INSERT_TAIL(&head, new Entry(type & 1, type & 2, re, macro),
+		                  entries);
+		g_free(macro);
+	}
+
+	return true;
+}
+
+/*
+ * Command states
+ */
+
+/*$ EA lexer
+ * [type]EApattern$macro$ -- Associate lexer macro with file type
+ * EA$$
+ * :EA$$ -> Success|Failure
+ * -EA$$
+ * EA$macro$ -> Success|Failure
+ *
+ * Associates the \fIpattern\fP with a lexer \fImacro\fP,
+ * i.e. the name of a global Q-Register, which is usually
+ * defined by the lexer configurations in the standard library
+ * and sets up syntax highlighting.
+ * If <type> is omitted or 0, \fIpattern\fP is a glob pattern
+ * that is matched against the entire file name of the current buffer
+ * (see \fBEN\fP).
+ * If <type> is 1, \fIpattern\fP is a search pattern that is matched
+ * against the beginning of the first line of the current document
+ * (e.g. a Hash-Bang line).
+ * The patterns are compiled only once, so they can be
+ * matched very efficiently.
+ * Q-Registers referenced by search patterns are thus
+ * expanded immediately.
+ * Adding 2 to <type> makes the association \fIbundled\fP:
+ * All Scintilla messages sent by \fBES\fP commands while
+ * \fImacro\fP is dispatched for the first time are recorded
+ * into a style bundle.
+ * Subsequent dispatches replay this bundle onto the current
+ * document in a single operation instead of executing
+ * the macro again.
+ * This should only be used for macros that exclusively
+ * set up Scintilla properties and styles independent of
+ * the document, since all other side effects and the
+ * messages' return values are lost.
+ *
+ * If both \fIpattern\fP and \fImacro\fP are empty,
+ * the patterns are matched in the order the associations
+ * have been added and the first matching \fImacro\fP is
+ * executed without creating a new local Q-Register table.
+ * When colon-modified, a boolean is returned that signals
+ * whether any pattern matched.
+ * This is used by the lexer configuration hook.
+ * If <type> is -1 (or just a minus sign) and both
+ * string arguments are empty,
+ * all style bundles are discarded, so they are
+ * recorded again on their next use.
+ * This should be done after changing the color scheme.
+ *
+ * If only \fIpattern\fP is empty, the command returns
+ * a boolean that signals whether any association with
+ * the lexer \fImacro\fP matches the current document,
+ * without executing the macro.
+ * This is used by the \(lqlexer.test\(rq macros defined
+ * by the standard library.
+ *
+ * String-building characters are enabled for both string
+ * arguments.
+ * Adding associations may be rubbed out.
+ */
+State *
+StateLexerPattern::done(const gchar *str)
+{
+	BEGIN_EXEC(&States::lexermacro);
+
+	g_free(undo.push_str(lexer_pattern));
+	lexer_pattern = g_strdup(str);
+
+	return &States::lexermacro;
+}
+
+State *
+StateLexerMacro::done(const gchar *str)
+{
+	BEGIN_EXEC(&States::start);
+
+	bool colon_modified = eval_colon();
+	tecoInt type;
+
+	expressions.eval();
+	type = expressions.pop_num_calc(0, expressions.num_sign < 0 ? -1 : 0);
+	if (type < -1 || type > 3)
+		throw Error("Invalid pattern type %" TECO_INTEGER_FORMAT
+		            " for <EA>", type);
+
+	if (!*lexer_pattern && !*str) {
+		if (type < 0) {
+			lexer_table.clear_bundles();
+		} else {
+			bool matched = lexer_table.dispatch();
+
+			if (colon_modified)
+				expressions.push(TECO_BOOL(matched));
+		}
+	} else if (!*lexer_pattern) {
+		expressions.push(TECO_BOOL(lexer_table.test(str)));
+	} else if (!*str) {
+		throw Error("Both pattern and macro expected for <EA>");
+	} else if (type < 0) {
+		throw Error("Invalid pattern type %" TECO_INTEGER_FORMAT
+		            " for <EA>", type);
+	} else {
+		lexer_table.add(type & 1, type & 2, lexer_pattern, str);
+		lexer_table.undo_add();
+	}
+
+	return &States::start;
+}
+
+} /* namespace SciTECO */
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2012-2017 Robin Haberkorn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LEXER_H
+#define __LEXER_H
+
+#include <bsd/sys/queue.h>
+
+#include <glib.h>
+
+#include <Scintilla.h>
+
+#include "sciteco.h"
+#include "memory.h"
+#include "parser.h"
+#include "undo.h"
+#include "qregisters.h"
+#include "snapshot.h"
+
+namespace SciTECO {
+
+/**
+ * A recording of the Scintilla messages sent by the
+ * ES command, e.g. while a lexer macro is executed.
+ * Replaying it restores the same lexer and style setup
+ * without executing any macro code.
+ * String arguments are copied into the bundle.
+ */
+class StyleBundle : public Object {
+	struct Message {
+		unsigned int iMessage;
+		uptr_t wParam;
+		sptr_t lParam;
+		/** offset of the string lParam in `strings` or -1 */
+		gssize lParam_offset;
+	};
+
+	GArray *messages;
+	GString *strings;
+
+public:
+	/** Bundle the ES command currently records into or NULL */
+	static StyleBundle *recording;
+
+	StyleBundle() : messages(g_array_new(FALSE, FALSE, sizeof(Message))),
+	                strings(g_string_new(NULL)) {}
+	~StyleBundle()
+	{
+		g_array_free(messages, TRUE);
+		g_string_free(strings, TRUE);
+	}
+
+	void append(unsigned int iMessage, uptr_t wParam,
+	            sptr_t lParam, const gchar *str = NULL);
+	void replay(void);
+};
+
+/**
+ * Associations of file name and header patterns with
+ * lexer macros.
+ * The patterns are compiled when they are added, so
+ * looking up the lexer for a document requires no macro
+ * calls at all.
+ * Associations are matched in the order they have been
+ * added.
+ */
+class LexerTable : public Object {
+	class Entry : public Object {
+	public:
+		TAILQ_ENTRY(Entry) entries;
+
+		/** Whether to match the first line instead of the file name */
+		bool header;
+		/** Whether to record the macro's ES messages into `bundle` */
+		bool bundled;
+		GRegex *pattern;
+		/** Name of the global Q-Register containing the macro */
+		gchar *macro;
+		/** Style bundle recorded on first use or NULL */
+		StyleBundle *bundle;
+
+		Entry(bool _header, bool _bundled,
+		      GRegex *_pattern, const gchar *_macro)
+		     : header(_header), bundled(_bundled), pattern(_pattern),
+		       macro(g_strdup(_macro)), bundle(NULL) {}
+		~Entry()
+		{
+			delete bundle;
+			g_regex_unref(pattern);
+			g_free(macro);
+		}
+	};
+
+	class UndoTokenRemove : public UndoToken {
+		LexerTable *table;
+
+	public:
+		UndoTokenRemove(LexerTable *_table)
+		               : table(_table) {}
+
+		void
+		run(void)
+		{
+			table->remove_last();
+		}
+	};
+
+	TAILQ_HEAD(Head, Entry) head;
+
+	void remove_last(void);
+	Entry *find(const gchar *macro = NULL);
+
+public:
+	LexerTable()
+	{
+		TAILQ_INIT(&head);
+	}
+	~LexerTable();
+
+	void add(bool header, bool bundled,
+	         const gchar *pattern, const gchar *macro);
+	inline void
+	undo_add(void)
+	{
+		undo.push<UndoTokenRemove>(this);
+	}
+
+	bool test(const gchar *macro);
+	bool dispatch(void);
+	void clear_bundles(void);
+
+	void write(SnapshotWriter &writer);
+	bool read(SnapshotReader &reader, bool apply);
+};
+
+extern LexerTable lexer_table;
+
+/*
+ * Command states
+ */
+
+class StateLexerPattern : public StateExpectString {
+public:
+	StateLexerPattern() : StateExpectString(true, false) {}
+
+private:
+	State *done(const gchar *str);
+};
+
+class StateLexerMacro : public StateExpectString {
+private:
+	State *done(const gchar *str);
+};
+
+namespace States {
+	extern StateLexerPattern	lexerpattern;
+	extern StateLexerMacro		lexermacro;
+}
+
+} /* namespace SciTECO */
+
+#endif
@@ -23,6 +23,16 @@
 #include <string.h>
 #include <stdlib.h>
 #include <signal.h>
+#include <errno.h>
+
+#if defined(G_OS_UNIX) || defined(G_OS_HAIKU)
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
 
 #include <glib.h>
 #include <glib/gprintf.h>
@@ -38,6 +48,7 @@
 #include "ring.h"
 #include "undo.h"
 #include "error.h"
+#include "snapshot.h"
 
 /*
  * Define this to pause the program at the beginning
@@ -76,6 +87,15 @@ namespace Flags {
 static gchar *eval_macro = NULL;
 static gboolean mung_file = FALSE;
 static gboolean mung_profile = TRUE;
+static gchar *snapshot_file = NULL;
+static gchar *image_file = NULL;
+static gchar *dump_image_file = NULL;
+static gboolean filter_stdin = FALSE;
+static gboolean filter_stdout = FALSE;
+static gboolean quiet = FALSE;
+static gboolean each_file = FALSE;
+static gint jobs = 1;
+static gchar *server_socket = NULL;
 
 sig_atomic_t sigint_occurred = FALSE;
 
@@ -176,6 +196,29 @@ process_options(int &argc, char **&argv)
 		 "Do not mung "
 		 "$SCITECOCONFIG" G_DIR_SEPARATOR_S INI_FILE " "
 		 "even if it exists"},
+		{"snapshot", 0, 0, G_OPTION_ARG_FILENAME, &snapshot_file,
+		 "Restore Q-Registers from snapshot file written by EP "
+		 "if it is up to date", "file"},
+		{"image", 0, 0, G_OPTION_ARG_FILENAME, &image_file,
+		 "Restore editor state from image file instead of munging "
+		 "the profile if it is up to date", "file"},
+		{"dump-image", 0, 0, G_OPTION_ARG_FILENAME, &dump_image_file,
+		 "Write editor state to image file after munging "
+		 "the profile and exit", "file"},
+		{"stdin", 'i', 0, G_OPTION_ARG_NONE, &filter_stdin,
+		 "Read standard input into the unnamed buffer"},
+		{"stdout", 'o', 0, G_OPTION_ARG_NONE, &filter_stdout,
+		 "Write the current buffer to standard output on exit"},
+		{"quiet", 'q', 0, G_OPTION_ARG_NONE, &quiet,
+		 "Do not print user and info messages in batch mode"},
+		{"each", 0, 0, G_OPTION_ARG_NONE, &each_file,
+		 "Apply the evaluated macro or munged script to every "
+		 "file given as an argument"},
+		{"jobs", 'j', 0, G_OPTION_ARG_INT, &jobs,
+		 "Number of worker processes for --each", "N"},
+		{"server", 0, 0, G_OPTION_ARG_FILENAME, &server_socket,
+		 "Execute macros sent to a Unix domain socket after "
+		 "munging the profile", "socket"},
 		{NULL}
 	};
 
@@ -241,6 +284,40 @@ process_options(int &argc, char **&argv)
 		argc--;
 	}
 
+	if (each_file) {
+		if (!eval_macro && !mung_file) {
+			g_fprintf(stderr, "--each requires --eval or --mung!\n");
+			exit(EXIT_FAILURE);
+		}
+		if (filter_stdin || filter_stdout) {
+			g_fprintf(stderr, "--each cannot be combined with "
+			                  "--stdin or --stdout!\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (server_socket) {
+#if defined(G_OS_UNIX) || defined(G_OS_HAIKU)
+		if (eval_macro || each_file || filter_stdin || filter_stdout) {
+			g_fprintf(stderr, "--server cannot be combined with "
+			                  "--eval, --each, --stdin or --stdout!\n");
+			exit(EXIT_FAILURE);
+		}
+#else
+		g_fprintf(stderr, "--server is not supported on this platform!\n");
+		exit(EXIT_FAILURE);
+#endif
+	}
+	if (dump_image_file && (eval_macro || each_file || server_socket)) {
+		/* these never return to dump the image */
+		g_fprintf(stderr, "--dump-image cannot be combined with "
+		                  "--eval, --each or --server!\n");
+		exit(EXIT_FAILURE);
+	}
+	if (jobs < 1) {
+		g_fprintf(stderr, "Invalid number of jobs %d!\n", jobs);
+		exit(EXIT_FAILURE);
+	}
+
 	if (mung_file) {
 		if (argc < 2) {
 			g_fprintf(stderr, "Script to mung expected!\n");
@@ -263,6 +340,625 @@ process_options(int &argc, char **&argv)
 	return mung_filename;
 }
 
+#ifdef G_OS_WIN32
+
+static inline GIOChannel *
+stdio_channel_new(gint fd)
+{
+	return g_io_channel_win32_new_fd(fd);
+}
+
+#else /* the UNIX constructors should work everywhere else */
+
+static inline GIOChannel *
+stdio_channel_new(gint fd)
+{
+	return g_io_channel_unix_new(fd);
+}
+
+#endif
+
+/**
+ * Load standard input into the unnamed buffer
+ * if requested with --stdin.
+ * The unnamed buffer is made the current buffer, since
+ * an image may already have restored another one,
+ * so it is also the buffer written by save_stdout().
+ */
+static inline void
+load_stdin(void)
+{
+	GIOChannel *channel;
+
+	if (!filter_stdin)
+		return;
+
+	ring.edit((const gchar *)NULL);
+
+	channel = stdio_channel_new(0);
+	g_io_channel_set_encoding(channel, NULL, NULL);
+	g_io_channel_set_buffered(channel, FALSE);
+
+	try {
+		ring.current->load(channel);
+	} catch (...) {
+		g_io_channel_unref(channel);
+		throw; /* forward */
+	}
+
+	g_io_channel_unref(channel);
+}
+
+/**
+ * Write the current buffer to standard output
+ * if requested with --stdout.
+ * This must be called only once on exit.
+ */
+static void
+save_stdout(void)
+{
+	GIOChannel *channel;
+
+	if (!filter_stdout)
+		return;
+
+	/* anything printed to stdout before must come first */
+	fflush(stdout);
+	channel = stdio_channel_new(1);
+	g_io_channel_set_encoding(channel, NULL, NULL);
+	/*
+	 * EOLWriterGIO expects the channel to be buffered
+	 * for performance reasons
+	 */
+	g_io_channel_set_buffered(channel, TRUE);
+
+	try {
+		ring.current->save(channel);
+	} catch (...) {
+		g_io_channel_unref(channel);
+		throw; /* forward */
+	}
+
+	/* also flushes the channel */
+	g_io_channel_unref(channel);
+}
+
+/*
+ * Result of processing a file with --each.
+ * Files that are still pending after all workers
+ * terminated have been claimed by crashed workers.
+ */
+enum EachStatus {
+	EACH_PENDING = 0,
+	EACH_SUCCESS,
+	EACH_FAILURE
+};
+
+/**
+ * Remove a file processed with --each from the ring,
+ * if it has not been closed by the macro itself.
+ */
+static void
+close_each_file(const gchar *filename)
+{
+	Buffer *buffer = ring.find(filename);
+
+	if (buffer) {
+		ring.edit(ring.get_id(buffer));
+		ring.close();
+	}
+}
+
+/**
+ * Apply the --each macro or script to a single file.
+ * The file is edited as the current buffer, saved if it
+ * has been modified and removed from the ring afterwards.
+ *
+ * @return The file's EachStatus.
+ */
+static guint8
+process_each_file(const gchar *filename, const gchar *each_script)
+{
+	Buffer *buffer;
+
+	try {
+		/* EB would silently create a new buffer */
+		if (!g_file_test(filename, G_FILE_TEST_IS_REGULAR))
+			throw Error("File \"%s\" does not exist", filename);
+
+		ring.edit(filename);
+
+		try {
+			if (each_script)
+				Execute::file(each_script);
+			else
+				Execute::macro(eval_macro);
+		} catch (Error &error) {
+			error.add_frame(new Error::ToplevelFrame());
+			throw; /* forward */
+		} catch (Quit) {
+			/* ^C only ends processing of this file */
+		}
+		quit_requested = false;
+
+		/* the macro might have closed the buffer itself */
+		buffer = ring.find(filename);
+		if (buffer && buffer->dirty)
+			buffer->save();
+		close_each_file(filename);
+	} catch (Error &error) {
+		error.display_full();
+		interface.msg(InterfaceCurrent::MSG_ERROR,
+		              "Processing \"%s\" failed", filename);
+		quit_requested = false;
+
+		/* discard the buffer without saving it */
+		try {
+			close_each_file(filename);
+		} catch (Error &error) {
+			error.display_full();
+		}
+		return EACH_FAILURE;
+	}
+
+	return EACH_SUCCESS;
+}
+
+#if defined(G_OS_UNIX) || defined(G_OS_HAIKU)
+
+/**
+ * Apply the --each macro or script to a single file
+ * in a child process.
+ * Every file is thus processed with the interpreter state
+ * left by the profile (global Q-Registers, flags, etc.),
+ * so the results do not depend on the order of the
+ * files or the number of jobs.
+ *
+ * @return The file's EachStatus.
+ */
+static guint8
+process_each_file_isolated(const gchar *filename, const gchar *each_script)
+{
+	pid_t pid;
+	int status;
+
+	/* inherited stdio buffers must not be written twice */
+	fflush(NULL);
+
+	pid = fork();
+	if (pid < 0) {
+		interface.msg(InterfaceCurrent::MSG_WARNING,
+		              "Cannot isolate processing of \"%s\": %s",
+		              filename, g_strerror(errno));
+		return process_each_file(filename, each_script);
+	}
+	if (!pid) {
+		guint8 ret = process_each_file(filename, each_script);
+
+		fflush(NULL);
+		/* skip destructors and exit handlers of the parent */
+		_exit(ret);
+	}
+
+	while (waitpid(pid, &status, 0) < 0) {
+		if (errno != EINTR)
+			return EACH_PENDING;
+	}
+
+	/* the file is reported as pending if the child crashed */
+	return WIFEXITED(status) ? WEXITSTATUS(status) : EACH_PENDING;
+}
+
+#else
+
+/*
+ * Without fork(), all files share the interpreter state.
+ */
+static inline guint8
+process_each_file_isolated(const gchar *filename, const gchar *each_script)
+{
+	return process_each_file(filename, each_script);
+}
+
+#endif
+
+/**
+ * Take files from the queue until it is empty.
+ *
+ * @param next Index of the next file to process.
+ *             It may be shared with other worker processes,
+ *             so it is updated atomically.
+ */
+static void
+process_each_queue(gint argc, char **argv, const gchar *each_script,
+                   gint *next, guint8 *status)
+{
+	gint i;
+
+	while ((i = g_atomic_int_add(next, 1)) < argc)
+		status[i] = process_each_file_isolated(argv[i], each_script);
+}
+
+#if defined(G_OS_UNIX) || defined(G_OS_HAIKU)
+
+/**
+ * Process files with --each using `jobs` worker processes.
+ * The workers inherit the munged profile and share the file
+ * queue and the per-file results via anonymous shared memory.
+ * This is only supported where fork() is available.
+ */
+static void
+process_each_jobs(gint argc, char **argv, const gchar *each_script,
+                  gint *next, guint8 *status)
+{
+	gsize size = sizeof(gint) + argc;
+	gint started = 0;
+	gpointer shared;
+	gint *shared_next;
+	guint8 *shared_status;
+
+	shared = mmap(NULL, size, PROT_READ | PROT_WRITE,
+	              MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED) {
+		interface.msg(InterfaceCurrent::MSG_WARNING,
+		              "Cannot share file queue between jobs: %s",
+		              g_strerror(errno));
+		process_each_queue(argc, argv, each_script, next, status);
+		return;
+	}
+	shared_next = (gint *)shared;
+	shared_status = (guint8 *)(shared_next + 1);
+	*shared_next = *next;
+	memset(shared_status, EACH_PENDING, argc);
+
+	/* inherited stdio buffers must not be written twice */
+	fflush(NULL);
+
+	for (gint i = 0; i < jobs; i++) {
+		pid_t pid = fork();
+
+		if (pid < 0) {
+			interface.msg(InterfaceCurrent::MSG_WARNING,
+			              "Cannot start job: %s", g_strerror(errno));
+			break;
+		}
+		if (!pid) {
+			process_each_queue(argc, argv, each_script,
+			                   shared_next, shared_status);
+			fflush(NULL);
+			/* skip destructors and exit handlers of the parent */
+			_exit(EXIT_SUCCESS);
+		}
+
+		started++;
+	}
+
+	/*
+	 * If not a single job could be started, the
+	 * files are processed by this process instead.
+	 */
+	if (!started)
+		process_each_queue(argc, argv, each_script,
+		                   shared_next, shared_status);
+
+	while (wait(NULL) > 0 || errno == EINTR);
+
+	memcpy(status, shared_status, argc);
+	munmap(shared, size);
+}
+
+#endif
+
+/**
+ * Apply the --each macro or script to all the files
+ * in argv and exit.
+ * This never returns.
+ */
+static void G_GNUC_NORETURN
+process_each(gint argc, char **argv, const gchar *each_script)
+{
+	gint next = 1, failed = 0;
+	guint8 status[argc];
+
+	memset(status, EACH_PENDING, argc);
+
+#if defined(G_OS_UNIX) || defined(G_OS_HAIKU)
+	if (jobs > 1 && argc > 2)
+		process_each_jobs(argc, argv, each_script, &next, status);
+	else
+#endif
+		process_each_queue(argc, argv, each_script, &next, status);
+
+	for (gint i = 1; i < argc; i++) {
+		switch (status[i]) {
+		case EACH_SUCCESS:
+			continue;
+		case EACH_PENDING:
+			interface.msg(InterfaceCurrent::MSG_ERROR,
+			              "Job processing \"%s\" terminated unexpectedly",
+			              argv[i]);
+			break;
+		}
+		failed++;
+	}
+
+	try {
+		QRegisters::hook(QRegisters::HOOK_QUIT);
+	} catch (Error &error) {
+		error.display_full();
+		exit(EXIT_FAILURE);
+	}
+
+	if (failed) {
+		interface.msg(InterfaceCurrent::MSG_ERROR,
+		              "%d of %d files failed", failed, argc-1);
+		exit(EXIT_FAILURE);
+	}
+
+	exit(EXIT_SUCCESS);
+}
+
+#if defined(G_OS_UNIX) || defined(G_OS_HAIKU)
+
+/**
+ * Apply a single --server request option.
+ * "quiet" suppresses all messages except errors and
+ * "cwd=DIR" changes the working directory.
+ */
+static void
+serve_option(const gchar *option)
+{
+	if (!strcmp(option, "quiet")) {
+		interface.stdio_msg_stream = NULL;
+	} else if (g_str_has_prefix(option, "cwd=")) {
+		const gchar *dir = option + 4;
+
+		if (g_chdir(dir))
+			throw Error("Cannot change working directory "
+			            "to \"%s\"", dir);
+	} else {
+		throw Error("Invalid request option \"%s\"", option);
+	}
+}
+
+/**
+ * Read a null-terminated request field.
+ * Fields that are not terminated, i.e. requests
+ * that end prematurely, are malformed.
+ */
+static void
+serve_read_field(GIOChannel *channel, GString *field)
+{
+	GError *gerror = NULL;
+	gsize terminator_pos = 0;
+
+	switch (g_io_channel_read_line_string(channel, field, &terminator_pos,
+	                                      &gerror)) {
+	case G_IO_STATUS_ERROR:
+		throw GlibError(gerror);
+	case G_IO_STATUS_NORMAL:
+		if (terminator_pos < field->len)
+			break;
+		/* fall through */
+	default:
+		throw Error("Malformed request: Unterminated field");
+	}
+
+	g_string_truncate(field, terminator_pos);
+}
+
+/**
+ * Handle a single --server request.
+ * This runs in a process forked for the request, so
+ * changes to the ring and Q-Registers do not affect
+ * subsequent requests.
+ *
+ * A request consists of the options, the macro, both
+ * terminated by a null byte, and the input that is loaded
+ * into the unnamed buffer.
+ * Every option is terminated by a line feed
+ * (see serve_option()).
+ * The client must shut down its side of the connection
+ * after writing the request.
+ * The response is either "OK" followed by a line feed and
+ * the contents of the current buffer after executing the macro
+ * or "ERROR", followed by the error message and a line feed.
+ * The buffer is streamed to the client after the status line.
+ * Since it is written to the connection that would also receive
+ * the error, failing to write it only closes the connection
+ * without another status line.
+ */
+static void
+serve_request(gint fd)
+{
+	GIOChannel *channel;
+	GString *options = g_string_new(NULL);
+	GString *macro = g_string_new(NULL);
+
+	channel = g_io_channel_unix_new(fd);
+	g_io_channel_set_encoding(channel, NULL, NULL);
+	g_io_channel_set_buffered(channel, TRUE);
+	g_io_channel_set_line_term(channel, "", 1);
+
+	try {
+		gchar **option_list;
+
+		serve_read_field(channel, options);
+		serve_read_field(channel, macro);
+
+		option_list = g_strsplit(options->str, "\n", -1);
+		try {
+			for (gchar **option = option_list; *option; option++)
+				if (**option)
+					serve_option(*option);
+		} catch (...) {
+			g_strfreev(option_list);
+			throw;
+		}
+		g_strfreev(option_list);
+
+		ring.edit((const gchar *)NULL);
+		ring.current->load(channel);
+
+		try {
+			Execute::macro(macro->str);
+		} catch (Error &error) {
+			error.add_frame(new Error::ToplevelFrame());
+			throw; /* forward */
+		} catch (Quit) {
+			/* ^C and EX only end the request */
+		}
+
+	} catch (Error &error) {
+		gchar *line;
+
+		error.display_full();
+
+		line = g_strdup_printf("ERROR %s\n", error.description);
+		g_io_channel_write_chars(channel, line, -1, NULL, NULL);
+		g_free(line);
+
+		goto cleanup;
+	}
+
+	/*
+	 * From here on, the response is committed to "OK".
+	 * Errors are only reported locally.
+	 */
+	try {
+		g_io_channel_write_chars(channel, "OK\n", -1, NULL, NULL);
+		ring.current->save(channel);
+	} catch (Error &error) {
+		error.display_full();
+	}
+
+cleanup:
+
+	g_io_channel_flush(channel, NULL);
+	g_io_channel_unref(channel);
+	g_string_free(options, TRUE);
+	g_string_free(macro, TRUE);
+}
+
+/**
+ * Accept --server requests on the Unix domain socket
+ * until SciTECO is interrupted and exit.
+ * Every request is handled by a forked process, so the
+ * profile is munged only once but requests are isolated
+ * from each other.
+ * This never returns.
+ */
+static void G_GNUC_NORETURN
+serve(const gchar *path)
+{
+	struct sockaddr_un addr;
+	struct sigaction action;
+	GStatBuf file_stat;
+	gint listen_fd;
+	mode_t mask;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(addr.sun_path))
+		throw Error("Socket path \"%s\" is too long", path);
+	strcpy(addr.sun_path, path);
+
+	listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listen_fd < 0)
+		throw Error("Cannot create socket: %s", g_strerror(errno));
+
+	/*
+	 * Remove the stale socket of a previous server,
+	 * unless that server is still running.
+	 */
+	if (!g_lstat(path, &file_stat) && S_ISSOCK(file_stat.st_mode)) {
+		if (!connect(listen_fd, (struct sockaddr *)&addr, sizeof(addr)))
+			throw Error("Socket \"%s\" is already in use", path);
+		close(listen_fd);
+		g_unlink(path);
+
+		listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listen_fd < 0)
+			throw Error("Cannot create socket: %s",
+			            g_strerror(errno));
+	}
+
+	/*
+	 * Requests can execute arbitrary macros,
+	 * so only the current user may connect.
+	 */
+	mask = umask(077);
+	if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+	    listen(listen_fd, SOMAXCONN)) {
+		umask(mask);
+		throw Error("Cannot listen on socket \"%s\": %s",
+		            path, g_strerror(errno));
+	}
+	umask(mask);
+
+	/*
+	 * accept() must not be restarted after SIGINT/SIGTERM,
+	 * so we can shut down the server.
+	 * Terminated request processes are reaped automatically.
+	 */
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = sigint_handler;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	signal(SIGCHLD, SIG_IGN);
+
+	interface.msg(InterfaceCurrent::MSG_INFO,
+	              "Listening on \"%s\"", path);
+
+	while (!sigint_occurred) {
+		gint fd = accept(listen_fd, NULL, NULL);
+		pid_t pid;
+
+		if (fd < 0) {
+			if (errno != EINTR && errno != ECONNABORTED)
+				interface.msg(InterfaceCurrent::MSG_WARNING,
+				              "Cannot accept request: %s",
+				              g_strerror(errno));
+			continue;
+		}
+
+		/* inherited stdio buffers must not be written twice */
+		fflush(NULL);
+
+		pid = fork();
+		if (!pid) {
+			close(listen_fd);
+			/* spawning processes requires waiting for them */
+			signal(SIGCHLD, SIG_DFL);
+			serve_request(fd);
+			fflush(NULL);
+			/* skip destructors and exit handlers of the server */
+			_exit(EXIT_SUCCESS);
+		}
+		if (pid < 0)
+			interface.msg(InterfaceCurrent::MSG_WARNING,
+			              "Cannot handle request: %s",
+			              g_strerror(errno));
+
+		close(fd);
+	}
+
+	close(listen_fd);
+	g_unlink(path);
+
+	try {
+		QRegisters::hook(QRegisters::HOOK_QUIT);
+	} catch (Error &error) {
+		error.display_full();
+		exit(EXIT_FAILURE);
+	}
+
+	exit(EXIT_SUCCESS);
+}
+
+#endif
+
 static inline void
 initialize_environment(const gchar *program)
 {
@@ -361,7 +1057,7 @@ main(int argc, char **argv)
 	static GotoTable	cmdline_goto_table;
 	static QRegisterTable	local_qregs;
 
-	gchar *mung_filename;
+	gchar *mung_filename, *each_script = NULL;
 
 #ifdef DEBUG_PAUSE
 	/* Windows debugging hack (see above) */
@@ -372,6 +1068,22 @@ main(int argc, char **argv)
 	signal(SIGTERM, sigint_handler);
 
 	mung_filename = process_options(argc, argv);
+	if (each_file) {
+		/*
+		 * The profile is munged once while the script
+		 * is munged for every file.
+		 */
+		each_script = mung_filename;
+		mung_filename = NULL;
+	}
+	/*
+	 * Standard output may be reserved for the buffer
+	 * contents, so messages are redirected.
+	 */
+	if (quiet)
+		interface.stdio_msg_stream = NULL;
+	else if (filter_stdout)
+		interface.stdio_msg_stream = stderr;
 	/*
 	 * All remaining arguments in argv are arguments
 	 * to the macro or munged file.
@@ -396,6 +1108,9 @@ main(int argc, char **argv)
 	QRegisters::globals.insert(new QRegisterWorkingDir());
 	/* environment defaults and registers */
 	initialize_environment(argv[0]);
+	/* may skip munging the standard library macros */
+	if (snapshot_file)
+		Snapshot::load(snapshot_file);
 
 	/* the default registers (A-Z and 0-9) */
 	local_qregs.insert_defaults();
@@ -403,8 +1118,11 @@ main(int argc, char **argv)
 
 	ring.edit((const gchar *)NULL);
 
-	/* add remaining arguments to unnamed buffer */
-	for (gint i = 1; i < argc; i++) {
+	/*
+	 * Add remaining arguments to unnamed buffer
+	 * unless they are files to process with --each.
+	 */
+	for (gint i = 1; i < argc && !each_file; i++) {
 		/*
 		 * FIXME: arguments may contain line-feeds.
 		 * Once SciTECO is 8-byte clear, we can add the
@@ -418,7 +1136,14 @@ main(int argc, char **argv)
 	 * Execute macro or mung file
 	 */
 	try {
-		if (eval_macro) {
+		/* an up to date image replaces the profile */
+		if (image_file && Snapshot::load_image(image_file))
+			mung_profile = FALSE;
+
+		/* after the image, which may change the current buffer */
+		load_stdin();
+
+		if (eval_macro && !each_file) {
 			try {
 				Execute::macro(eval_macro, false);
 			} catch (Error &error) {
@@ -431,6 +1156,7 @@ main(int argc, char **argv)
 				 */
 			}
 			QRegisters::hook(QRegisters::HOOK_QUIT);
+			save_stdout();
 			exit(EXIT_SUCCESS);
 		}
 
@@ -441,6 +1167,8 @@ main(int argc, char **argv)
 
 		if (mung_filename &&
 		    g_file_test(mung_filename, G_FILE_TEST_IS_REGULAR)) {
+			/* only files munged by the profile are snapshotted */
+			Snapshot::set_recording(true);
 			try {
 				Execute::file(mung_filename, false);
 			} catch (Quit) {
@@ -449,12 +1177,27 @@ main(int argc, char **argv)
 				 * be executed.
 				 */
 			}
+			Snapshot::add_source(mung_filename);
+			Snapshot::set_recording(false);
 
 			if (quit_requested) {
 				QRegisters::hook(QRegisters::HOOK_QUIT);
+				save_stdout();
 				exit(EXIT_SUCCESS);
 			}
 		}
+
+		if (each_file)
+			process_each(argc, argv, each_script);
+#if defined(G_OS_UNIX) || defined(G_OS_HAIKU)
+		if (server_socket)
+			serve(server_socket);
+#endif
+
+		if (dump_image_file) {
+			Snapshot::dump_image(dump_image_file);
+			exit(EXIT_SUCCESS);
+		}
 	} catch (Error &error) {
 		error.display_full();
 		exit(EXIT_FAILURE);
@@ -488,6 +1231,7 @@ main(int argc, char **argv)
 
 	try {
 		QRegisters::hook(QRegisters::HOOK_QUIT);
+		save_stdout();
 	} catch (Error &error) {
 		error.display_full();
 		exit(EXIT_FAILURE);
@@ -36,10 +36,13 @@
 #include "qregisters.h"
 #include "ring.h"
 #include "parser.h"
+#include "rbtree.h"
 #include "symbols.h"
 #include "search.h"
 #include "spawn.h"
 #include "glob.h"
+#include "lexer.h"
+#include "snapshot.h"
 #include "help.h"
 #include "cmdline.h"
 #include "ioview.h"
@@ -103,7 +106,7 @@ static guint loop_stack_fp = 0;
  * SciTECO::Cmdline *.
  */
 void
-Execute::step(const gchar *macro, gint stop_pos)
+Execute::step(const gchar *macro, gint stop_pos, bool refresh)
 {
 	try {
 		/*
@@ -123,8 +126,11 @@ Execute::step(const gchar *macro, gint stop_pos)
 
 				if (interface.is_interrupted())
 					throw Error("Interrupted");
+				interface.progress_poll();
 
 				memlimit.check();
+				/* clipboards may change between commands */
+				QRegisterClipboard::invalidate_caches();
 
 				State::input(macro[macro_pc]);
 				macro_pc++;
@@ -135,11 +141,12 @@ Execute::step(const gchar *macro, gint stop_pos)
 			 * PC is at the end of the command line.
 			 * This will actually be called in other situations,
 			 * like at the end of macros but that does not hurt.
-			 * It should perhaps be in Cmdline::insert(),
+			 * It should perhaps be in Cmdline::refresh(),
 			 * but doing it here ensures that exceptions get
 			 * normalized.
 			 */
-			States::current->refresh();
+			if (refresh)
+				States::current->refresh();
 		} catch (std::exception &error) {
 			throw StdError(error);
 		}
@@ -197,9 +204,11 @@ Execute::macro(const gchar *macro, bool locals)
 	/*
 	 * Locals are only initialized when needed to
 	 * improve the speed of local macro calls.
+	 * The default registers are even only created
+	 * on first access.
 	 */
 	if (locals) {
-		macro_locals.insert_defaults();
+		macro_locals.insert_defaults_lazily();
 		QRegisters::locals = &macro_locals;
 	}
 
@@ -392,7 +401,7 @@ bool
 StringBuildingMachine::input(gchar chr, gchar *&result)
 {
 	QRegister *reg;
-	gchar *str;
+	SharedString *str;
 
 	switch (mode) {
 	case MODE_UPPER:
@@ -516,9 +525,9 @@ StateCtlEQuote:
 
 	undo.push_obj(qregspec_machine) = NULL;
 	set(StateStart);
-	str = reg->get_string();
-	result = g_shell_quote(str);
-	g_free(str);
+	str = reg->get_shared_string();
+	result = g_shell_quote(str->str);
+	str->unref();
 	return true;
 
 StateCtlEN:
@@ -527,9 +536,9 @@ StateCtlEN:
 
 	undo.push_obj(qregspec_machine) = NULL;
 	set(StateStart);
-	str = reg->get_string();
-	result = Globber::escape_pattern(str);
-	g_free(str);
+	str = reg->get_shared_string();
+	result = Globber::escape_pattern(str->str);
+	str->unref();
 	return true;
 
 StateEscaped:
@@ -609,7 +618,8 @@ StateExpectString::custom(gchar chr)
 		}
 
 		g_free(string);
-		insert_len = 0;
+		/* insertions may have been pending since the last refresh() */
+		undo.push_var(insert_len) = 0;
 		return next;
 	}
 
@@ -619,12 +629,10 @@ StateExpectString::custom(gchar chr)
 	 * String building characters and
 	 * string argument accumulation.
 	 *
-	 * NOTE: As an optimization insert_len is not
-	 * restored on undo since that is only
-	 * necessary in interactive mode and we get
-	 * called once per character when this is necessary.
-	 * If this gets too confusing, just undo changes
-	 * to insert_len.
+	 * NOTE: insert_len must be restored on undo since
+	 * the command line refreshes only once per keypress,
+	 * so rubbing out a character may leave several
+	 * characters pending for the next refresh().
 	 */
 	if (string_building) {
 		gchar *insert;
@@ -634,13 +642,13 @@ StateExpectString::custom(gchar chr)
 
 		undo.push_str(strings[0]);
 		String::append(strings[0], insert);
-		insert_len += strlen(insert);
+		undo.push_var(insert_len) += strlen(insert);
 
 		g_free(insert);
 	} else {
 		undo.push_str(strings[0]);
 		String::append(strings[0], chr);
-		insert_len++;
+		undo.push_var(insert_len)++;
 	}
 
 	return this;
@@ -650,9 +658,10 @@ void
 StateExpectString::refresh(void)
 {
 	/* never calls process() in parse-only mode */
-	if (insert_len)
+	if (insert_len) {
 		process(strings[0], insert_len);
-	insert_len = 0;
+		undo.push_var(insert_len) = 0;
+	}
 }
 
 State *
@@ -2187,12 +2196,14 @@ StateECommand::StateECommand()
 {
 	transitions['\0'] = this;
 	transitions['%'] = &States::epctcommand;
+	transitions['A'] = &States::lexerpattern;
 	transitions['B'] = &States::editfile;
 	transitions['C'] = &States::executecommand;
 	transitions['G'] = &States::egcommand;
 	transitions['I'] = &States::insert_nobuilding;
 	transitions['M'] = &States::macro_file;
 	transitions['N'] = &States::glob_pattern;
+	transitions['P'] = &States::savesnapshot;
 	transitions['S'] = &States::scintilla_symbols;
 	transitions['Q'] = &States::eqcommand;
 	transitions['U'] = &States::eucommand;
@@ -2317,7 +2328,8 @@ StateECommand::custom(gchar chr)
 	 *
 	 * The following property keys are defined:
 	 * .IP 0 4
-	 * The current user interface: 1 for Curses, 2 for GTK
+	 * The current user interface: 1 for Curses, 2 for GTK,
+	 * 0 for the headless batch-processing interface
 	 * (\fBread-only\fP)
 	 * .IP 1
 	 * The current numbfer of buffers: Also the numeric id
@@ -2392,6 +2404,20 @@ StateECommand::custom(gchar chr)
 	 * on exit the author is aware of is \fBxterm\fP(1) and
 	 * the Linux console driver.
 	 * You have been warned. Good luck.
+	 * .IP 4
+	 * The maximum number of screen updates per second
+	 * while executing long-running command lines or macros.
+	 * This allows watching the progress of commands that would
+	 * otherwise freeze the screen until they terminate.
+	 * The current buffer or Q-Register, the command line and the
+	 * time elapsed since the last keypress are displayed.
+	 * Screen updates are never performed per character, so
+	 * they do not degrade performance significantly.
+	 * Setting this property to 0 disables screen updates
+	 * during execution.
+	 * This is currently only effective on Curses as the
+	 * GTK+ interface updates the screen asynchronously anyway.
+	 * The default is 20.
 	 */
 	case 'J': {
 		BEGIN_EXEC(&States::start);
@@ -2400,7 +2426,8 @@ StateECommand::custom(gchar chr)
 			EJ_USER_INTERFACE = 0,
 			EJ_BUFFERS,
 			EJ_MEMORY_LIMIT,
-			EJ_INIT_COLOR
+			EJ_INIT_COLOR,
+			EJ_PROGRESS_RATE
 		};
 		tecoInt property;
 
@@ -2425,6 +2452,13 @@ StateECommand::custom(gchar chr)
 				                     (guint32)expressions.pop_num_calc());
 				break;
 
+			case EJ_PROGRESS_RATE:
+				if (value < 0 || value > 1000)
+					throw Error("Invalid screen update rate %" TECO_INTEGER_FORMAT
+					            " specified for <EJ>", value);
+				undo.push_var(interface.progress_rate) = value;
+				break;
+
 			default:
 				throw Error("Cannot set property %" TECO_INTEGER_FORMAT
 				            " for <EJ>", property);
@@ -2439,6 +2473,8 @@ StateECommand::custom(gchar chr)
 			expressions.push(1);
 #elif defined(INTERFACE_GTK)
 			expressions.push(2);
+#elif defined(INTERFACE_NULL)
+			expressions.push(0);
 #else
 #error Missing value for current interface!
 #endif
@@ -2452,6 +2488,10 @@ StateECommand::custom(gchar chr)
 			expressions.push(memlimit.limit);
 			break;
 
+		case EJ_PROGRESS_RATE:
+			expressions.push(interface.progress_rate);
+			break;
+
 		default:
 			throw Error("Invalid property %" TECO_INTEGER_FORMAT
 			            " for <EJ>", property);
@@ -2606,11 +2646,123 @@ StateECommand::custom(gchar chr)
 	return &States::start;
 }
 
-static struct ScintillaMessage {
+struct ScintillaMessage {
 	unsigned int	iMessage;
 	uptr_t		wParam;
 	sptr_t		lParam;
-} scintilla_message = {0, 0, 0};
+};
+
+static ScintillaMessage scintilla_message = {0, 0, 0};
+
+/**
+ * Cache of resolved symbolic ES arguments.
+ * Macros usually pass the same constant symbols over and
+ * over again, so they have to be split and looked up only once.
+ * Values of 0 mean that the argument was not specified
+ * symbolically.
+ */
+static class ScintillaSymbolsCache : private RBTreeString, public Object {
+	class Entry : public RBTreeString::RBEntryOwnString {
+	public:
+		ScintillaMessage message;
+
+		Entry(const gchar *str, const ScintillaMessage &_message)
+		       : RBEntryOwnString(str), message(_message) {}
+	};
+
+	/*
+	 * The symbols might be built dynamically,
+	 * so the cache is flushed when it grows too large.
+	 */
+	static const guint max_entries = 1024;
+	guint entries;
+
+	static void resolve(const gchar *str, ScintillaMessage &message);
+
+public:
+	ScintillaSymbolsCache() : entries(0) {}
+	~ScintillaSymbolsCache()
+	{
+		clear();
+	}
+
+	const ScintillaMessage &lookup(const gchar *str);
+
+	inline void
+	clear(void)
+	{
+		Entry *cur;
+
+		while ((cur = (Entry *)root()))
+			delete (Entry *)RBTreeString::remove(cur);
+		entries = 0;
+	}
+} scintilla_symbols_cache;
+
+void
+ScintillaSymbolsCache::resolve(const gchar *str, ScintillaMessage &message)
+{
+	gchar **symbols = g_strsplit(str, ",", -1);
+	tecoInt v;
+
+	try {
+		if (!symbols[0])
+			goto cleanup;
+		if (*symbols[0]) {
+			v = Symbols::scintilla.lookup(symbols[0], "SCI_");
+			if (v < 0)
+				throw Error("Unknown Scintilla message symbol \"%s\"",
+					    symbols[0]);
+			message.iMessage = v;
+		}
+
+		if (!symbols[1])
+			goto cleanup;
+		if (*symbols[1]) {
+			v = Symbols::scilexer.lookup(symbols[1]);
+			if (v < 0)
+				throw Error("Unknown Scintilla Lexer symbol \"%s\"",
+					    symbols[1]);
+			message.wParam = v;
+		}
+
+		if (!symbols[2])
+			goto cleanup;
+		if (*symbols[2]) {
+			v = Symbols::scilexer.lookup(symbols[2]);
+			if (v < 0)
+				throw Error("Unknown Scintilla Lexer symbol \"%s\"",
+					    symbols[2]);
+			message.lParam = v;
+		}
+	} catch (...) {
+		g_strfreev(symbols);
+		throw;
+	}
+
+cleanup:
+	g_strfreev(symbols);
+}
+
+const ScintillaMessage &
+ScintillaSymbolsCache::lookup(const gchar *str)
+{
+	Entry *cached = (Entry *)find(str);
+	ScintillaMessage message = {0, 0, 0};
+
+	if (cached)
+		return cached->message;
+
+	resolve(str, message);
+
+	if (entries == max_entries)
+		clear();
+	cached = new Entry(str, message);
+	insert(cached);
+	entries++;
+
+	return cached->message;
+}
 
 /*$ ES scintilla message
  * -- Send Scintilla message
@@ -2666,43 +2818,8 @@ StateScintilla_symbols::done(const gchar *str)
 	BEGIN_EXEC(&States::scintilla_lparam);
 
 	undo.push_var(scintilla_message);
-	if (*str) {
-		gchar **symbols = g_strsplit(str, ",", -1);
-		tecoInt v;
-
-		if (!symbols[0])
-			goto cleanup;
-		if (*symbols[0]) {
-			v = Symbols::scintilla.lookup(symbols[0], "SCI_");
-			if (v < 0)
-				throw Error("Unknown Scintilla message symbol \"%s\"",
-					    symbols[0]);
-			scintilla_message.iMessage = v;
-		}
-
-		if (!symbols[1])
-			goto cleanup;
-		if (*symbols[1]) {
-			v = Symbols::scilexer.lookup(symbols[1]);
-			if (v < 0)
-				throw Error("Unknown Scintilla Lexer symbol \"%s\"",
-					    symbols[1]);
-			scintilla_message.wParam = v;
-		}
-
-		if (!symbols[2])
-			goto cleanup;
-		if (*symbols[2]) {
-			v = Symbols::scilexer.lookup(symbols[2]);
-			if (v < 0)
-				throw Error("Unknown Scintilla Lexer symbol \"%s\"",
-					    symbols[2]);
-			scintilla_message.lParam = v;
-		}
-
-cleanup:
-		g_strfreev(symbols);
-	}
+	if (*str)
+		scintilla_message = scintilla_symbols_cache.lookup(str);
 
 	expressions.eval();
 	if (!scintilla_message.iMessage) {
@@ -2722,6 +2839,8 @@ StateScintilla_lParam::done(const gchar *str)
 {
 	BEGIN_EXEC(&States::start);
 
+	bool lParam_string = !scintilla_message.lParam && *str;
+
 	if (!scintilla_message.lParam)
 		scintilla_message.lParam = *str ? (sptr_t)str
 						: expressions.pop_num_calc(0, 0);
@@ -2730,6 +2849,12 @@ StateScintilla_lParam::done(const gchar *str)
 				       scintilla_message.wParam,
 				       scintilla_message.lParam));
 
+	if (StyleBundle::recording)
+		StyleBundle::recording->append(scintilla_message.iMessage,
+					       scintilla_message.wParam,
+					       scintilla_message.lParam,
+					       lParam_string ? str : NULL);
+
 	undo.push_var(scintilla_message);
 	memset(&scintilla_message, 0, sizeof(scintilla_message));
 
@@ -475,7 +475,7 @@ typedef ValueStack<LoopContext> LoopStack;
 extern LoopStack loop_stack;
 
 namespace Execute {
-	void step(const gchar *macro, gint stop_pos);
+	void step(const gchar *macro, gint stop_pos, bool refresh = true);
 	void macro(const gchar *macro, bool locals = true);
 	void file(const gchar *filename, bool locals = true);
 }
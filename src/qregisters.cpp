@@ -40,6 +40,7 @@
 #include "eol.h"
 #include "error.h"
 #include "qregisters.h"
+#include "snapshot.h"
 
 namespace SciTECO {
 
@@ -72,9 +73,165 @@ namespace QRegisters {
 
 static QRegister *register_argument = NULL;
 
+SharedString::SharedString(const gchar *_str, gsize _len)
+                          : refs(1), allocated(_len+1), len(_len)
+{
+	str = (gchar *)g_malloc(allocated);
+	if (_len)
+		memcpy(str, _str, _len);
+	str[_len] = '\0';
+}
+
+void
+SharedString::append(const gchar *_str, gsize _len)
+{
+	g_assert(!is_shared());
+
+	if (len + _len + 1 > allocated) {
+		/*
+		 * Grow exponentially, so that appending lots
+		 * of small strings (e.g. EG) is efficient.
+		 */
+		allocated = MAX(allocated*2, len + _len + 1);
+		str = (gchar *)g_realloc(str, allocated);
+	}
+
+	memcpy(str+len, _str, _len);
+	len += _len;
+	str[len] = '\0';
+}
+
+void
+SharedString::truncate(gsize _len)
+{
+	g_assert(!is_shared());
+
+	if (_len < len) {
+		len = _len;
+		str[len] = '\0';
+	}
+}
+
+void
+QRegisterData::QRegisterString::demote(SharedString *_plain)
+{
+	drop_snapshot();
+	release_document();
+	if (plain)
+		plain->unref();
+	plain = _plain;
+}
+
+void
+QRegisterData::QRegisterString::exchange(QRegisterString &other)
+{
+	SharedString *temp_plain = plain;
+	gint temp_eol_mode = eol_mode;
+
+	drop_snapshot();
+	other.drop_snapshot();
+	Document::exchange(other);
+
+	plain = other.plain;
+	eol_mode = other.eol_mode;
+
+	other.plain = temp_plain;
+	other.eol_mode = temp_eol_mode;
+}
+
+void
+QRegisterData::QRegisterString::undo_exchange(void)
+{
+	undo.push<UndoTokenDropSnapshot>(this);
+	Document::undo_exchange();
+	undo.push_var(plain);
+	undo.push_var(eol_mode);
+}
+
+void
+QRegisterData::UndoTokenSetString::run(void)
+{
+	if (*ptr)
+		(*ptr)->unref();
+	*ptr = plain;
+	plain = NULL;
+}
+
+void
+QRegisterData::UndoTokenTruncateString::run(void)
+{
+	string->unshare();
+	if (string->plain)
+		string->plain->truncate(len);
+}
+
+void
+QRegisterData::UndoTokenPromote::run(void)
+{
+	string->demote(plain);
+	plain = NULL;
+}
+
+/**
+ * Move the plain string into a newly created
+ * Scintilla document.
+ *
+ * This is done when a register is edited for the first
+ * time, so the currently edited register is always backed
+ * by a document.
+ * The caller must update the currently edited document before
+ * and is responsible for making it current again afterwards.
+ * It does not generate undo tokens.
+ *
+ * @return The former plain string which is owned by the caller
+ *         (may be NULL).
+ */
+SharedString *
+QRegisterData::promote_string(void)
+{
+	SharedString *plain = string.plain;
+
+	if (string.is_initialized())
+		return NULL;
+
+	string.edit(QRegisters::view);
+
+	/*
+	 * The string is only moved, so there is nothing to
+	 * undo in the Scintilla document.
+	 */
+	QRegisters::view.ssm(SCI_SETUNDOCOLLECTION, FALSE);
+	QRegisters::view.ssm(SCI_SETEOLMODE, string.eol_mode);
+	if (plain)
+		QRegisters::view.ssm(SCI_APPENDTEXT, plain->len, (sptr_t)plain->str);
+	QRegisters::view.ssm(SCI_SETUNDOCOLLECTION, TRUE);
+
+	string.plain = NULL;
+	return plain;
+}
+
 void
 QRegisterData::set_string(const gchar *str, gsize len)
 {
+	if (!string.is_initialized()) {
+		/*
+		 * NOTE: A plain string cannot be the currently
+		 * edited document, so we can modify it without
+		 * switching documents.
+		 */
+		string.reset();
+
+		/*
+		 * The old string might still be borrowed
+		 * (see get_shared_string()), so it is not
+		 * modified in-place.
+		 */
+		if (string.plain)
+			string.plain->unref();
+		string.plain = len ? new SharedString(str, len) : NULL;
+		return;
+	}
+
 	if (QRegisters::current)
 		QRegisters::current->string.update(QRegisters::view);
 
@@ -91,12 +248,70 @@ QRegisterData::set_string(const gchar *str, gsize len)
 		QRegisters::current->string.edit(QRegisters::view);
 }
 
+/**
+ * Set the register's string to a shared string.
+ *
+ * Plain strings are not copied, instead the register
+ * references `str` until one of its users modifies it
+ * (copy-on-write).
+ * This takes over the caller's reference on `str`.
+ *
+ * @param str Shared string to set.
+ */
+void
+QRegisterData::set_shared_string(SharedString *str)
+{
+	if (string.is_initialized()) {
+		copy_shared_string(str);
+		return;
+	}
+
+	string.reset();
+
+	if (string.plain)
+		string.plain->unref();
+	if (str->len) {
+		string.plain = str;
+	} else {
+		string.plain = NULL;
+		str->unref();
+	}
+}
+
+/**
+ * Set the register's string by copying a shared string.
+ * This is the fallback of set_shared_string() for registers
+ * that cannot share strings.
+ * The reference on `str` is always released.
+ */
+void
+QRegisterData::copy_shared_string(SharedString *str)
+{
+	try {
+		set_string(str->str, str->len);
+	} catch (...) {
+		str->unref();
+		throw; /* forward */
+	}
+	str->unref();
+}
+
 void
 QRegisterData::undo_set_string(void)
 {
 	if (!must_undo)
 		return;
 
+	if (!string.is_initialized()) {
+		/*
+		 * set_string() never modifies plain strings in-place,
+		 * so keeping a reference is sufficient.
+		 */
+		string.undo_reset();
+		undo.push<UndoTokenSetString>(string.plain, string.plain);
+		return;
+	}
+
 	/*
 	 * Necessary, so that upon rubout the
 	 * string's parameters are restored.
@@ -124,6 +339,16 @@ QRegisterData::append_string(const gchar *str, gsize len)
 	if (!len)
 		return;
 
+	if (!string.is_initialized()) {
+		if (string.plain) {
+			string.unshare();
+			string.plain->append(str, len);
+		} else {
+			string.plain = new SharedString(str, len);
+		}
+		return;
+	}
+
 	if (QRegisters::current)
 		QRegisters::current->string.update(QRegisters::view);
 
@@ -138,6 +363,21 @@ QRegisterData::append_string(const gchar *str, gsize len)
 		QRegisters::current->string.edit(QRegisters::view);
 }
 
+void
+QRegisterData::undo_append_string(void)
+{
+	if (!must_undo)
+		return;
+
+	if (!string.is_initialized()) {
+		undo.push<UndoTokenTruncateString>(&string,
+		                                   string.plain ? string.plain->len : 0);
+		return;
+	}
+
+	undo_set_string();
+}
+
 gchar *
 QRegisterData::get_string(void)
 {
@@ -145,7 +385,9 @@ QRegisterData::get_string(void)
 	gchar *str;
 
 	if (!string.is_initialized())
-		return g_strdup("");
+		return string.plain ? (gchar *)g_memdup(string.plain->str,
+		                                        string.plain->len + 1)
+		                    : g_strdup("");
 
 	if (QRegisters::current)
 		QRegisters::current->string.update(QRegisters::view);
@@ -162,13 +404,77 @@ QRegisterData::get_string(void)
 	return str;
 }
 
+/**
+ * Get a read-only reference to the register's string.
+ *
+ * Plain strings are not copied, so this is much cheaper
+ * than get_string() for large registers.
+ * The string is guaranteed not to change while the
+ * reference is held, i.e. it is a snapshot even if the register
+ * is modified in the meantime.
+ *
+ * @return Shared string that must be released with
+ *         SharedString::unref().
+ */
+SharedString *
+QRegisterData::get_shared_string(void)
+{
+	if (!string.is_initialized())
+		return string.plain ? string.plain->ref() : new SharedString;
+
+	if ((QRegisterData *)QRegisters::current != this)
+		/* shared until the document is modified */
+		return get_snapshot()->ref();
+
+	/*
+	 * The current register's document may be modified
+	 * at any time, so it must be copied.
+	 * It is already in the view.
+	 */
+	gsize size = QRegisters::view.ssm(SCI_GETLENGTH);
+	gchar *str = (gchar *)g_malloc(size + 1);
+	QRegisters::view.ssm(SCI_GETTEXT, size + 1, (sptr_t)str);
+
+	return SharedString::take(str, size);
+}
+
+/**
+ * Get the snapshot of a document-backed register
+ * that is not currently edited, creating it if necessary.
+ *
+ * @return Borrowed reference to the snapshot.
+ */
+SharedString *
+QRegisterData::get_snapshot(void)
+{
+	if (string.snapshot)
+		return string.snapshot;
+
+	if (QRegisters::current)
+		QRegisters::current->string.update(QRegisters::view);
+
+	string.edit(QRegisters::view);
+
+	gsize size = QRegisters::view.ssm(SCI_GETLENGTH);
+	gchar *str = (gchar *)g_malloc(size + 1);
+	QRegisters::view.ssm(SCI_GETTEXT, size + 1, (sptr_t)str);
+
+	if (QRegisters::current)
+		QRegisters::current->string.edit(QRegisters::view);
+
+	return string.snapshot = SharedString::take(str, size);
+}
+
 gsize
 QRegisterData::get_string_size(void)
 {
 	gsize size;
 
 	if (!string.is_initialized())
-		return 0;
+		return string.plain ? string.plain->len : 0;
+
+	if (string.snapshot)
+		return string.snapshot->len;
 
 	if (QRegisters::current)
 		QRegisters::current->string.update(QRegisters::view);
@@ -186,23 +492,26 @@ QRegisterData::get_string_size(void)
 gint
 QRegisterData::get_character(gint position)
 {
-	gint ret = -1;
+	SharedString *str;
 
 	if (position < 0)
 		return -1;
 
-	if (QRegisters::current)
-		QRegisters::current->string.update(QRegisters::view);
-
-	string.edit(QRegisters::view);
+	if (!string.is_initialized())
+		return string.plain && position < (gint)string.plain->len
+				? string.plain->str[position] : -1;
 
-	if (position < QRegisters::view.ssm(SCI_GETLENGTH))
-		ret = QRegisters::view.ssm(SCI_GETCHARAT, position);
+	if ((QRegisterData *)QRegisters::current == this)
+		/* already in the view */
+		return position < QRegisters::view.ssm(SCI_GETLENGTH)
+				? QRegisters::view.ssm(SCI_GETCHARAT, position) : -1;
 
-	if (QRegisters::current)
-		QRegisters::current->string.edit(QRegisters::view);
-
-	return ret;
+	/*
+	 * Switching documents for every character would be
+	 * very slow, so characters are read from the snapshot.
+	 */
+	str = get_snapshot();
+	return position < (gint)str->len ? str->str[position] : -1;
 }
 
 void
@@ -217,9 +526,30 @@ QRegisterData::undo_exchange_string(QRegisterData &reg)
 void
 QRegister::edit(void)
 {
+	/*
+	 * Modifications of the current document could
+	 * not be undone.
+	 */
+	if (is_scratch())
+		throw QRegOpUnsupportedError(name);
+
 	if (QRegisters::current)
 		QRegisters::current->string.update(QRegisters::view);
 
+	if (!string.is_initialized()) {
+		/*
+		 * Promote the plain string to a Scintilla document.
+		 * On rubout, the plain string is restored and
+		 * the document released.
+		 */
+		SharedString *plain = promote_string();
+
+		if (must_undo)
+			undo.push_own<UndoTokenPromote>(&string, plain);
+		else if (plain)
+			plain->unref();
+	}
+
 	string.edit(QRegisters::view);
 	interface.show_view(&QRegisters::view);
 	interface.info_update(this);
@@ -245,21 +575,26 @@ QRegister::undo_edit(void)
 void
 QRegister::execute(bool locals)
 {
-	gchar *str = get_string();
+	/*
+	 * The macro is borrowed, not copied.
+	 * Modifications of the register while the
+	 * macro is running do not affect it.
+	 */
+	SharedString *macro = get_shared_string();
 
 	try {
-		Execute::macro(str, locals);
+		Execute::macro(macro->str, locals);
 	} catch (Error &error) {
 		error.add_frame(new Error::QRegFrame(name));
 
-		g_free(str);
+		macro->unref();
 		throw; /* forward */
 	} catch (...) {
-		g_free(str);
+		macro->unref();
 		throw; /* forward */
 	}
 
-	g_free(str);
+	macro->unref();
 }
 
 void
@@ -268,6 +603,11 @@ QRegister::undo_set_eol_mode(void)
 	if (!must_undo)
 		return;
 
+	if (!string.is_initialized()) {
+		undo.push_var(string.eol_mode);
+		return;
+	}
+
 	/*
 	 * Necessary, so that upon rubout the
 	 * string's parameters are restored.
@@ -286,6 +626,11 @@ QRegister::undo_set_eol_mode(void)
 void
 QRegister::set_eol_mode(gint mode)
 {
+	if (!string.is_initialized()) {
+		string.eol_mode = mode;
+		return;
+	}
+
 	if (QRegisters::current)
 		QRegisters::current->string.update(QRegisters::view);
 
@@ -296,9 +641,34 @@ QRegister::set_eol_mode(gint mode)
 		QRegisters::current->string.edit(QRegisters::view);
 }
 
+gint
+QRegister::get_eol_mode(void)
+{
+	gint ret;
+
+	if (!string.is_initialized())
+		return string.eol_mode;
+
+	if (QRegisters::current)
+		QRegisters::current->string.update(QRegisters::view);
+
+	string.edit(QRegisters::view);
+	ret = QRegisters::view.ssm(SCI_GETEOLMODE);
+
+	if (QRegisters::current)
+		QRegisters::current->string.edit(QRegisters::view);
+
+	return ret;
+}
+
 void
 QRegister::load(const gchar *filename)
 {
+	if (!string.is_initialized()) {
+		load_string(filename);
+		return;
+	}
+
 	undo_set_string();
 
 	if (QRegisters::current)
@@ -324,24 +694,89 @@ QRegister::load(const gchar *filename)
 		QRegisters::current->string.edit(QRegisters::view);
 }
 
+/**
+ * Load a file into the plain string.
+ * This is the equivalent of IOView::load()
+ * for registers not backed by a Scintilla document.
+ * The file is read into memory only once and
+ * EOLs are translated in-place, so the register
+ * takes over the file's buffer.
+ */
 void
-QRegister::save(const gchar *filename)
+QRegister::load_string(const gchar *filename)
 {
-	if (QRegisters::current)
-		QRegisters::current->string.update(QRegisters::view);
+	GError *error = NULL;
+	gchar *str;
+	gsize str_len;
 
-	string.edit(QRegisters::view);
+	/*
+	 * NOTE: g_file_get_contents() always null-terminates,
+	 * so there is room for convert_in_place().
+	 */
+	if (!g_file_get_contents(filename, &str, &str_len, &error)) {
+		Error err("Error reading file \"%s\": %s",
+		          filename, error->message);
+		g_error_free(error);
+		throw err;
+	}
 
-	try {
+	EOLReaderMem reader(str, str_len);
+
+	/*
+	 * NOTE: Reading from memory cannot fail.
+	 */
+	str_len = reader.convert_in_place();
+
+	undo_set_string();
+	set_shared_string(SharedString::take(str, str_len));
+
+	/*
+	 * See IOView::load(): The EOL style is only set
+	 * if it could be guessed.
+	 */
+	if (reader.eol_style >= 0) {
+		undo_set_eol_mode();
+		set_eol_mode(reader.eol_style);
+	}
+
+	if (reader.eol_style_inconsistent)
+		interface.msg(InterfaceCurrent::MSG_WARNING,
+		              "Inconsistent EOL styles normalized");
+}
+
+void
+QRegister::save(const gchar *filename)
+{
+	if (!string.is_initialized()) {
+		save_string(filename, string.plain ? string.plain->str : NULL,
+		            string.plain ? string.plain->len : 0, string.eol_mode);
+		return;
+	}
+
+	/*
+	 * IOView::save() writes straight from the document's
+	 * gap buffer, so the register is not copied.
+	 * If it is currently edited, it is already in the view.
+	 */
+	if (QRegisters::current == this) {
 		QRegisters::view.save(filename);
-	} catch (...) {
+	} else {
+		if (QRegisters::current)
+			QRegisters::current->string.update(QRegisters::view);
+
+		string.edit(QRegisters::view);
+
+		try {
+			QRegisters::view.save(filename);
+		} catch (...) {
+			if (QRegisters::current)
+				QRegisters::current->string.edit(QRegisters::view);
+			throw; /* forward */
+		}
+
 		if (QRegisters::current)
 			QRegisters::current->string.edit(QRegisters::view);
-		throw; /* forward */
 	}
-
-	if (QRegisters::current)
-		QRegisters::current->string.edit(QRegisters::view);
 }
 
 tecoInt
@@ -510,15 +945,20 @@ QRegisterWorkingDir::undo_exchange_string(QRegisterData &reg)
 	reg.undo_set_string();
 }
 
+guint QRegisterClipboard::cache_serial = 0;
+
 void
 QRegisterClipboard::UndoTokenSetClipboard::run(void)
 {
 	interface.set_clipboard(name, str, str_len);
+	QRegisterClipboard::invalidate_caches();
 }
 
 void
 QRegisterClipboard::set_string(const gchar *str, gsize len)
 {
+	drop_cache();
+
 	if (Flags::ed & Flags::ED_AUTOEOL) {
 		GString *str_converted = g_string_sized_new(len);
 		/*
@@ -574,8 +1014,12 @@ QRegisterClipboard::undo_set_string(void)
 	undo.push<UndoTokenSetClipboard>(get_clipboard_name(), str, str_len);
 }
 
+/**
+ * Fetch the clipboard contents from the user interface,
+ * converting EOLs if necessary.
+ */
 gchar *
-QRegisterClipboard::get_string(gsize *out_len)
+QRegisterClipboard::fetch_string(gsize *out_len)
 {
 	if (!(Flags::ed & Flags::ED_AUTOEOL)) {
 		/*
@@ -602,6 +1046,40 @@ QRegisterClipboard::get_string(gsize *out_len)
 	return str_converted;
 }
 
+/**
+ * Get the clipboard contents, fetching them
+ * at most once per command.
+ *
+ * @return A new reference to the cached contents.
+ */
+SharedString *
+QRegisterClipboard::fetch(void)
+{
+	if (!cache || cached_serial != cache_serial) {
+		gchar *str;
+		gsize str_len;
+
+		drop_cache();
+		str = fetch_string(&str_len);
+		cache = SharedString::take(str, str_len);
+		cached_serial = cache_serial;
+	}
+
+	return cache->ref();
+}
+
+gchar *
+QRegisterClipboard::get_string(gsize *out_len)
+{
+	SharedString *str = fetch();
+	gchar *ret = (gchar *)g_memdup(str->str, str->len+1);
+
+	if (out_len)
+		*out_len = str->len;
+	str->unref();
+	return ret;
+}
+
 gchar *
 QRegisterClipboard::get_string(void)
 {
@@ -611,59 +1089,39 @@ QRegisterClipboard::get_string(void)
 gsize
 QRegisterClipboard::get_string_size(void)
 {
-	gsize str_len;
-	gchar *str = interface.get_clipboard(get_clipboard_name(), &str_len);
-	/*
-	 * Using the EOLReader does not hurt much if AutoEOL is disabled
-	 * since we use it only for counting the bytes.
-	 */
-	EOLReaderMem reader(str, str_len);
-	gsize data_len;
-	gsize converted_len = 0;
+	SharedString *str = fetch();
+	gsize ret = str->len;
 
-	try {
-		while (reader.convert(data_len))
-			converted_len += data_len;
-	} catch (...) {
-		g_free(str);
-		throw; /* forward */
-	}
-	g_free(str);
-
-	return converted_len;
+	str->unref();
+	return ret;
 }
 
 gint
 QRegisterClipboard::get_character(gint position)
 {
-	gsize str_len;
-	gchar *str = QRegisterClipboard::get_string(&str_len);
+	SharedString *str = fetch();
 	gint ret = -1;
 
-	/*
-	 * `str` may be NULL, but only if str_len == 0 as well.
-	 */
 	if (position >= 0 &&
-	    position < (gint)str_len)
-		ret = str[position];
+	    position < (gint)str->len)
+		ret = str->str[position];
 
-	g_free(str);
+	str->unref();
 	return ret;
 }
 
 void
 QRegisterClipboard::edit(void)
 {
-	gchar *str;
-	gsize str_len;
+	SharedString *str;
 
 	QRegister::edit();
 
 	QRegisters::view.ssm(SCI_BEGINUNDOACTION);
 	QRegisters::view.ssm(SCI_CLEARALL);
-	str = QRegisterClipboard::get_string(&str_len);
-	QRegisters::view.ssm(SCI_APPENDTEXT, str_len, (sptr_t)str);
-	g_free(str);
+	str = fetch();
+	QRegisters::view.ssm(SCI_APPENDTEXT, str->len, (sptr_t)str->str);
+	str->unref();
 	QRegisters::view.ssm(SCI_ENDUNDOACTION);
 
 	QRegisters::view.undo_ssm(SCI_UNDO);
@@ -672,21 +1130,10 @@ QRegisterClipboard::edit(void)
 void
 QRegisterClipboard::exchange_string(QRegisterData &reg)
 {
-	gchar *own_str;
-	gsize own_str_len;
-	gchar *other_str = reg.get_string();
-	gsize other_str_len = reg.get_string_size();
+	SharedString *own_str = fetch();
 
-	/*
-	 * FIXME: What if `reg` is a clipboard and it changes
-	 * between the two calls?
-	 * QRegister::get_string() should always return the length as well.
-	 */
-	QRegisterData::set_string(other_str, other_str_len);
-	g_free(other_str);
-	own_str = QRegisterClipboard::get_string(&own_str_len);
-	reg.set_string(own_str, own_str_len);
-	g_free(own_str);
+	QRegisterData::set_shared_string(reg.get_shared_string());
+	reg.set_shared_string(own_str);
 }
 
 void
@@ -739,6 +1186,29 @@ QRegisterTable::insert_defaults(void)
 		insert(q);
 }
 
+/**
+ * Insert a default register (see insert_defaults())
+ * that has not yet been accessed.
+ *
+ * @param name Name of the register to insert.
+ * @return The new register or NULL if `name` does
+ *         not refer to a default register.
+ */
+QRegister *
+QRegisterTable::insert_default(const gchar *name)
+{
+	if (!name[0] || name[1] ||
+	    !(g_ascii_isupper(name[0]) || g_ascii_isdigit(name[0])))
+		return NULL;
+
+	/*
+	 * NOTE: Lazy default registers do not have to be
+	 * removed on rubout since they existed before
+	 * from the user's point of view.
+	 */
+	return insert(name[0]);
+}
+
 /*
  * NOTE: by not making this inline,
  * we can access QRegisters::current
@@ -888,6 +1358,10 @@ QRegisterTable::clear(void)
 {
 	QRegister *cur;
 
+	/*
+	 * NOTE: With lazy default registers, this is
+	 * usually a no-op for local macro calls.
+	 */
 	while ((cur = (QRegister *)root())) {
 		if (cur == QRegisters::current)
 			throw Error("Currently edited Q-Register \"%s\" "
@@ -918,10 +1392,11 @@ QRegisterStack::push(QRegister &reg)
 {
 	Entry *entry = new Entry();
 
-	gchar *str = reg.get_string();
-	if (*str)
-		entry->set_string(str);
-	g_free(str);
+	/*
+	 * Plain strings are shared between the register
+	 * and the stack entry until either one is modified.
+	 */
+	entry->set_shared_string(reg.get_shared_string());
 	entry->string.update(reg.string);
 	entry->set_integer(reg.get_integer());
 
@@ -942,7 +1417,27 @@ QRegisterStack::pop(QRegister &reg)
 
 	/* exchange document ownership between Stack entry and Q-Register */
 	reg.undo_exchange_string(*entry);
-	reg.exchange_string(*entry);
+
+	if (&reg == QRegisters::current) {
+		/*
+		 * The currently edited register must always be
+		 * backed by a Scintilla document and the view
+		 * must show the new document.
+		 * Promoting the stack entry does not have to be undone.
+		 */
+		reg.string.update(QRegisters::view);
+		if (reg.must_undo)
+			reg.string.undo_edit(QRegisters::view);
+
+		SharedString *plain = entry->promote_string();
+		if (plain)
+			plain->unref();
+
+		reg.exchange_string(*entry);
+		reg.string.edit(QRegisters::view);
+	} else {
+		reg.exchange_string(*entry);
+	}
 
 	SLIST_REMOVE_HEAD(&head, entries);
 	/* Pass entry ownership to undo stack. */
@@ -1469,23 +1964,23 @@ StateSetQRegString::done(const gchar *str)
 State *
 StateGetQRegString::got_register(QRegister *reg)
 {
-	gchar *str;
+	SharedString *str;
 
 	machine.reset();
 
 	BEGIN_EXEC(&States::start);
 
-	str = reg->get_string();
-	if (*str) {
+	str = reg->get_shared_string();
+	if (str->len) {
 		interface.ssm(SCI_BEGINUNDOACTION);
-		interface.ssm(SCI_ADDTEXT, strlen(str), (sptr_t)str);
+		interface.ssm(SCI_ADDTEXT, str->len, (sptr_t)str->str);
 		interface.ssm(SCI_SCROLLCARET);
 		interface.ssm(SCI_ENDUNDOACTION);
 		ring.dirtify();
 
 		interface.undo_ssm(SCI_UNDO);
 	}
-	g_free(str);
+	str->unref();
 
 	return &States::start;
 }
@@ -1570,9 +2065,15 @@ StateIncreaseQReg::got_register(QRegister *reg)
  * and this failure propagates until the top-level macro (e.g.
  * the command-line macro).
  *
- * Note that the string of <q> will be copied upon macro execution,
- * so subsequent changes to Q-Register <q> from inside the macro do
- * not modify the executed code.
+ * The macro does not copy the string of <q> but
+ * shares it with the register.
+ * Modifying Q-Register <q> while the macro is running,
+ * e.g. from inside the macro itself, gives the register a new string
+ * (copy-on-write), so the executed code is never modified.
+ * The running macro completes with its original code, while
+ * the next invocation of <q> executes the new one.
+ * Macros in registers that have been edited (see \fBEQ\fP)
+ * are still copied.
  */
 State *
 StateMacro::got_register(QRegister *reg)
@@ -1599,8 +2100,18 @@ State *
 StateMacroFile::got_file(const gchar *filename)
 {
 	BEGIN_EXEC(&States::start);
-	/* don't create new local Q-Registers if colon modifier is given */
-	Execute::file(filename, !eval_colon());
+
+	/*
+	 * The file's effects might have already been
+	 * restored from a Q-Register snapshot.
+	 * Still, the colon modifier must be evaluated.
+	 */
+	bool locals = !eval_colon();
+	if (!Snapshot::skip_source(filename))
+		/* don't create new local Q-Registers if colon modifier is given */
+		Execute::file(filename, locals);
+	Snapshot::add_source(filename);
+
 	return &States::start;
 }
 
@@ -1667,12 +2178,18 @@ StateCopyToQReg::got_register(QRegister *reg)
 
 	if (eval_colon()) {
 		reg->undo_append_string();
-		reg->append_string(tr.lpstrText);
+		try {
+			reg->append_string(tr.lpstrText, len);
+		} catch (...) {
+			g_free(tr.lpstrText);
+			throw; /* forward */
+		}
+		g_free(tr.lpstrText);
 	} else {
 		reg->undo_set_string();
-		reg->set_string(tr.lpstrText);
+		/* the register takes over the copied text */
+		reg->set_shared_string(SharedString::take(tr.lpstrText, len));
 	}
-	g_free(tr.lpstrText);
 
 	return &States::start;
 }
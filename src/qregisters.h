@@ -48,17 +48,182 @@ namespace QRegisters {
  * Classes
  */
 
+/**
+ * Reference-counted string storage.
+ *
+ * Plain Q-Register strings are kept in these buffers,
+ * so they can be borrowed by readers (e.g. macro calls)
+ * without copying.
+ * A shared string must not be modified, so writers
+ * have to copy it first (see QRegisterData::QRegisterString::unshare()).
+ * This guarantees that borrowed strings are snapshots.
+ *
+ * The string is always null-terminated, but may
+ * contain null bytes.
+ */
+class SharedString : public Object {
+	guint refs;
+	gsize allocated;
+
+public:
+	gchar *str;
+	gsize len;
+
+	SharedString(const gchar *_str = NULL, gsize _len = 0);
+	~SharedString()
+	{
+		g_free(str);
+	}
+
+	/**
+	 * Construct a shared string, taking ownership of
+	 * the null-terminated and g_malloc()ed string `_str`.
+	 */
+	static inline SharedString *
+	take(gchar *_str, gsize _len)
+	{
+		SharedString *ret = new SharedString;
+
+		/* `_str` may be NULL for empty strings */
+		if (_str) {
+			g_free(ret->str);
+			ret->str = _str;
+			ret->len = _len;
+			ret->allocated = _len+1;
+		}
+		return ret;
+	}
+
+	inline SharedString *
+	ref(void)
+	{
+		refs++;
+		return this;
+	}
+	inline void
+	unref(void)
+	{
+		if (!--refs)
+			delete this;
+	}
+
+	inline bool
+	is_shared(void)
+	{
+		return refs > 1;
+	}
+
+	void append(const gchar *_str, gsize _len);
+	void truncate(gsize _len);
+};
+
 class QRegisterData : public Object {
 protected:
 	tecoInt integer;
 
 	class QRegisterString : public Document {
+		class UndoTokenDropSnapshot : public UndoToken {
+			QRegisterString *string;
+
+		public:
+			UndoTokenDropSnapshot(QRegisterString *_string)
+			                     : string(_string) {}
+
+			void
+			run(void)
+			{
+				string->drop_snapshot();
+			}
+		};
+
 	public:
+		/**
+		 * Plain string storage.
+		 * Q-Register strings are kept in this length-carrying
+		 * buffer (may be NULL for empty strings) until the register
+		 * is edited (EQ) for the first time.
+		 * Only then the string is moved into a Scintilla document,
+		 * since switching documents (SCI_SETDOCPOINTER) is slow.
+		 * Once the document exists, `plain` is unused and the
+		 * document is authoritative.
+		 */
+		SharedString *plain;
+		/**
+		 * EOL mode of the plain string.
+		 * Documents store their own EOL mode.
+		 */
+		gint eol_mode;
+		/**
+		 * Read-only copy of the document's contents (or NULL).
+		 * It allows reading document-backed registers
+		 * without switching documents and is dropped
+		 * whenever the document might be modified.
+		 */
+		SharedString *snapshot;
+
+		QRegisterString() : plain(NULL), snapshot(NULL)
+		{
+#ifdef G_OS_WIN32
+			eol_mode = SC_EOL_CRLF;
+#else
+			eol_mode = SC_EOL_LF;
+#endif
+		}
+
 		~QRegisterString()
 		{
+			if (plain)
+				plain->unref();
+			drop_snapshot();
 			release_document();
 		}
 
+		inline void
+		drop_snapshot(void)
+		{
+			if (snapshot)
+				snapshot->unref();
+			snapshot = NULL;
+		}
+
+		/*
+		 * Documents can only be modified while they are
+		 * edited (or when the editing is undone), so this
+		 * is where snapshots are invalidated.
+		 */
+		inline void
+		edit(ViewCurrent &view)
+		{
+			drop_snapshot();
+			Document::edit(view);
+		}
+		inline void
+		undo_edit(ViewCurrent &view)
+		{
+			undo.push<UndoTokenDropSnapshot>(this);
+			Document::undo_edit(view);
+		}
+
+		/**
+		 * Make sure that the plain string is not shared,
+		 * so it can be modified in-place.
+		 */
+		inline void
+		unshare(void)
+		{
+			if (plain && plain->is_shared()) {
+				SharedString *copy = new SharedString(plain->str,
+				                                      plain->len);
+				plain->unref();
+				plain = copy;
+			}
+		}
+
+		void demote(SharedString *_plain);
+
+		void exchange(QRegisterString &other);
+		void undo_exchange(void);
+
 	private:
 		ViewCurrent &
 		get_create_document_view(void)
@@ -67,6 +232,78 @@ protected:
 		}
 	} string;
 
+	/**
+	 * Restores a plain string on rubout.
+	 */
+	class UndoTokenSetString : public UndoToken {
+		SharedString **ptr;
+		SharedString *plain;
+
+	public:
+		/**
+		 * Construct undo token.
+		 *
+		 * The token keeps a reference on `_plain`,
+		 * so the string does not have to be copied.
+		 */
+		UndoTokenSetString(SharedString *&variable, SharedString *_plain)
+		                  : ptr(&variable),
+		                    plain(_plain ? _plain->ref() : NULL) {}
+		~UndoTokenSetString()
+		{
+			if (plain)
+				plain->unref();
+		}
+
+		void run(void);
+	};
+
+	/**
+	 * Restores a plain string after appending to it.
+	 * This avoids copying the entire string.
+	 */
+	class UndoTokenTruncateString : public UndoToken {
+		QRegisterString *string;
+		gsize len;
+
+	public:
+		UndoTokenTruncateString(QRegisterString *_string, gsize _len)
+		                       : string(_string), len(_len) {}
+
+		void run(void);
+	};
+
+	/**
+	 * Reverts the promotion of a plain string
+	 * to a Scintilla document.
+	 */
+	class UndoTokenPromote : public UndoToken {
+		QRegisterString *string;
+		SharedString *plain;
+
+	public:
+		/**
+		 * Construct undo token.
+		 *
+		 * This passes ownership of the plain string
+		 * to the token.
+		 */
+		UndoTokenPromote(QRegisterString *_string, SharedString *_plain)
+		                : string(_string), plain(_plain) {}
+		~UndoTokenPromote()
+		{
+			if (plain)
+				plain->unref();
+		}
+
+		void run(void);
+	};
+
+	SharedString *promote_string(void);
+	SharedString *get_snapshot(void);
+
+	void copy_shared_string(SharedString *str);
+
 public:
 	/*
 	 * Whether to generate UndoTokens (unnecessary in macro invocations).
@@ -104,6 +341,7 @@ public:
 	{
 		set_string(str, str ? strlen(str) : 0);
 	}
+	virtual void set_shared_string(SharedString *str);
 	virtual void undo_set_string(void);
 
 	virtual void append_string(const gchar *str, gsize len);
@@ -112,12 +350,9 @@ public:
 	{
 		append_string(str, str ? strlen(str) : 0);
 	}
-	virtual inline void
-	undo_append_string(void)
-	{
-		undo_set_string();
-	}
+	virtual void undo_append_string(void);
 	virtual gchar *get_string(void);
+	virtual SharedString *get_shared_string(void);
 	virtual gsize get_string_size(void);
 	virtual gint get_character(gint position);
 
@@ -149,6 +384,20 @@ public:
 
 	virtual ~QRegister() {}
 
+	/**
+	 * Whether this is a scratch register.
+	 * Scratch registers never record undo tokens
+	 * and cannot be edited, so they always keep
+	 * plain strings.
+	 * The single-character register "!" is not
+	 * a scratch register.
+	 */
+	inline bool
+	is_scratch(void) const
+	{
+		return name[0] == '!' && name[1];
+	}
+
 	virtual void edit(void);
 	virtual void undo_edit(void);
 
@@ -156,6 +405,7 @@ public:
 
 	void undo_set_eol_mode(void);
 	void set_eol_mode(gint mode);
+	gint get_eol_mode(void);
 
 	/*
 	 * Load and save already care about undo token
@@ -163,6 +413,9 @@ public:
 	 */
 	void load(const gchar *filename);
 	void save(const gchar *filename);
+
+private:
+	void load_string(const gchar *filename);
 };
 
 class QRegisterBufferInfo : public QRegister {
@@ -180,6 +433,12 @@ public:
 	{
 		throw QRegOpUnsupportedError(name);
 	}
+	void
+	set_shared_string(SharedString *str)
+	{
+		str->unref();
+		throw QRegOpUnsupportedError(name);
+	}
 	void undo_set_string(void) {}
 
 	void
@@ -190,6 +449,12 @@ public:
 	void undo_append_string(void) {}
 
 	gchar *get_string(void);
+	SharedString *
+	get_shared_string(void)
+	{
+		gchar *str = get_string();
+		return SharedString::take(str, strlen(str));
+	}
 	gsize get_string_size(void);
 	gint get_character(gint pos);
 
@@ -201,6 +466,11 @@ public:
 	QRegisterWorkingDir() : QRegister("$") {}
 
 	void set_string(const gchar *str, gsize len);
+	void
+	set_shared_string(SharedString *str)
+	{
+		copy_shared_string(str);
+	}
 	void undo_set_string(void);
 
 	void
@@ -211,6 +481,12 @@ public:
 	void undo_append_string(void) {}
 
 	gchar *get_string(void);
+	SharedString *
+	get_shared_string(void)
+	{
+		gchar *str = get_string();
+		return SharedString::take(str, strlen(str));
+	}
 	gsize get_string_size(void);
 	gint get_character(gint pos);
 
@@ -254,13 +530,56 @@ class QRegisterClipboard : public QRegister {
 		return name+1;
 	}
 
+	/**
+	 * Serial number of the current command.
+	 * Clipboard contents are cached for the duration of a
+	 * command, so they have to be fetched only once
+	 * even if both string and size are required.
+	 */
+	static guint cache_serial;
+
+	/** Cached (EOL-converted) clipboard contents or NULL */
+	SharedString *cache;
+	guint cached_serial;
+
+	inline void
+	drop_cache(void)
+	{
+		if (cache)
+			cache->unref();
+		cache = NULL;
+	}
+
+	gchar *fetch_string(gsize *out_len);
+	SharedString *fetch(void);
+
 public:
-	QRegisterClipboard(const gchar *_name = NULL)
+	QRegisterClipboard(const gchar *_name = NULL) : cache(NULL)
 	{
 		name = g_strconcat("~", _name, NIL);
 	}
+	~QRegisterClipboard()
+	{
+		drop_cache();
+	}
+
+	/**
+	 * Invalidate the contents cached by all clipboard registers.
+	 * Must be called whenever a new command is executed,
+	 * as the clipboard may be changed by other applications.
+	 */
+	static inline void
+	invalidate_caches(void)
+	{
+		cache_serial++;
+	}
 
 	void set_string(const gchar *str, gsize len);
+	void
+	set_shared_string(SharedString *str)
+	{
+		copy_shared_string(str);
+	}
 	void undo_set_string(void);
 
 	/*
@@ -275,6 +594,11 @@ public:
 
 	gchar *get_string(gsize *out_len);
 	gchar *get_string(void);
+	SharedString *
+	get_shared_string(void)
+	{
+		return fetch();
+	}
 	gsize get_string_size(void);
 	gint get_character(gint pos);
 
@@ -305,10 +629,17 @@ class QRegisterTable : private RBTreeString, public Object {
 	};
 
 	bool must_undo;
+	/**
+	 * Whether the default registers are inserted
+	 * on first access (see find()).
+	 */
+	bool lazy_defaults;
+
+	QRegister *insert_default(const gchar *name);
 
 public:
 	QRegisterTable(bool _must_undo = true)
-	              : must_undo(_must_undo) {}
+	              : must_undo(_must_undo), lazy_defaults(false) {}
 
 	~QRegisterTable()
 	{
@@ -323,7 +654,7 @@ public:
 	inline QRegister *
 	insert(QRegister *reg)
 	{
-		reg->must_undo = must_undo;
+		reg->must_undo = must_undo && !reg->is_scratch();
 		RBTreeString::insert(reg);
 		return reg;
 	}
@@ -340,11 +671,26 @@ public:
 	}
 
 	void insert_defaults(void);
+	/**
+	 * Insert the default registers on demand.
+	 * This makes setting up and clearing tables cheap
+	 * if the default registers are never used,
+	 * as is the case for most local macro calls.
+	 */
+	inline void
+	insert_defaults_lazily(void)
+	{
+		lazy_defaults = true;
+	}
 
 	inline QRegister *
 	find(const gchar *name)
 	{
-		return (QRegister *)RBTreeString::find(name);
+		QRegister *reg = (QRegister *)RBTreeString::find(name);
+
+		if (G_UNLIKELY(!reg && lazy_defaults))
+			reg = insert_default(name);
+		return reg;
 	}
 	inline QRegister *
 	operator [](const gchar *name)
@@ -364,6 +710,12 @@ public:
 		return (QRegister *)RBTreeString::nfind(name);
 	}
 
+	inline QRegister *
+	first(void)
+	{
+		return (QRegister *)min();
+	}
+
 	void edit(QRegister *reg);
 	inline QRegister *
 	edit(const gchar *name)
@@ -122,6 +122,21 @@ public:
 	}
 	void save(const gchar *filename = NULL);
 
+	/*
+	 * Stream buffer contents without touching the
+	 * file name (e.g. for --stdin and --stdout).
+	 */
+	inline void
+	load(GIOChannel *channel)
+	{
+		IOView::load(channel);
+	}
+	inline void
+	save(GIOChannel *channel)
+	{
+		IOView::save(channel);
+	}
+
 	/*
 	 * Ring manages the buffer list and has privileged
 	 * access.
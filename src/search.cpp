@@ -36,6 +36,10 @@
 
 namespace SciTECO {
 
+/** Flags for compiling search patterns */
+static const gint regex_flags = G_REGEX_CASELESS | G_REGEX_MULTILINE |
+                                G_REGEX_DOTALL | G_REGEX_RAW;
+
 namespace States {
 	StateSearch			search;
 	StateSearchAll			searchall;
@@ -188,7 +192,8 @@ StateSearch::class2regexp(MatchState &state, const gchar *&pattern,
 {
 	while (*pattern) {
 		QRegister *reg;
-		gchar *temp, *temp2;
+		gchar *temp;
+		SharedString *shared;
 
 		switch (state) {
 		case STATE_START:
@@ -263,13 +268,13 @@ StateSearch::class2regexp(MatchState &state, const gchar *&pattern,
 				break;
 			qreg_machine.reset();
 
-			temp = reg->get_string();
-			temp2 = g_regex_escape_string(temp, -1);
-			g_free(temp);
+			shared = reg->get_shared_string();
+			temp = g_regex_escape_string(shared->str, -1);
+			shared->unref();
 
 			pattern++;
 			state = STATE_START;
-			return temp2;
+			return temp;
 
 		default:
 			/*
@@ -521,12 +526,47 @@ StateSearch::do_search(GRegex *re, gint from, gint to, gint &count)
 		interface.ssm(SCI_SETSEL, matched_from, matched_to);
 }
 
+/**
+ * Compile a search pattern into a regular expression,
+ * so it can be matched repeatedly without executing
+ * search commands.
+ * Q-Registers referenced by the pattern are expanded
+ * at compile time.
+ *
+ * @param pattern The search pattern.
+ * @return A new compiled regular expression object
+ *         or NULL if the pattern is invalid.
+ *         Unref after use.
+ */
+GRegex *
+StateSearch::compile_pattern(const gchar *pattern)
+{
+	gchar *re_pattern;
+	GRegex *re;
+
+	/*
+	 * NOTE: pattern2regexp() modifies pattern pointer and may throw
+	 */
+	try {
+		re_pattern = pattern2regexp(pattern);
+	} catch (...) {
+		qreg_machine.reset();
+		throw; /* forward */
+	}
+	qreg_machine.reset();
+	if (!re_pattern)
+		return NULL;
+
+	re = g_regex_new(re_pattern, (GRegexCompileFlags)regex_flags,
+			 (GRegexMatchFlags)0, NULL);
+	g_free(re_pattern);
+
+	return re;
+}
+
 void
 StateSearch::process(const gchar *str, gint new_chars)
 {
-	static const gint flags = G_REGEX_CASELESS | G_REGEX_MULTILINE |
-				  G_REGEX_DOTALL | G_REGEX_RAW;
-
 	QRegister *search_reg = QRegisters::globals["_"];
 
 	gchar *re_pattern;
@@ -552,7 +592,7 @@ StateSearch::process(const gchar *str, gint new_chars)
 #endif
 	if (!re_pattern)
 		goto failure;
-	re = g_regex_new(re_pattern, (GRegexCompileFlags)flags,
+	re = g_regex_new(re_pattern, (GRegexCompileFlags)regex_flags,
 			 (GRegexMatchFlags)0, NULL);
 	g_free(re_pattern);
 	if (!re)
@@ -634,9 +674,15 @@ StateSearch::done(const gchar *str)
 
 		interface.ssm(SCI_SETANCHOR, anchor);
 	} else {
-		gchar *search_str = search_reg->get_string();
-		process(search_str, 0 /* unused */);
-		g_free(search_str);
+		SharedString *search_str = search_reg->get_shared_string();
+
+		try {
+			process(search_str->str, 0 /* unused */);
+		} catch (...) {
+			search_str->unref();
+			throw; /* forward */
+		}
+		search_str->unref();
 	}
 
 	if (eval_colon())
@@ -920,9 +966,16 @@ StateReplaceDefault_insert::done(const gchar *str)
 		replace_reg->undo_set_string();
 		replace_reg->set_string(str);
 	} else {
-		gchar *replace_str = replace_reg->get_string();
-		StateInsert::process(replace_str, strlen(replace_str));
-		g_free(replace_str);
+		SharedString *replace_str = replace_reg->get_shared_string();
+
+		try {
+			StateInsert::process(replace_str->str,
+			                     strlen(replace_str->str));
+		} catch (...) {
+			replace_str->unref();
+			throw; /* forward */
+		}
+		replace_str->unref();
 	}
 
 	return &States::start;
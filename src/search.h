@@ -34,6 +34,8 @@ class StateSearch : public StateExpectString {
 public:
 	StateSearch(bool last = true) : StateExpectString(true, last) {}
 
+	GRegex *compile_pattern(const gchar *pattern);
+
 protected:
 	struct Parameters {
 		gint dot;
@@ -0,0 +1,702 @@
+/*
+ * Copyright (C) 2012-2017 Robin Haberkorn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <typeinfo>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "sciteco.h"
+#include "interface.h"
+#include "parser.h"
+#include "memory.h"
+#include "qregisters.h"
+#include "ring.h"
+#include "ioview.h"
+#include "help.h"
+#include "lexer.h"
+#include "error.h"
+#include "snapshot.h"
+
+namespace SciTECO {
+
+namespace States {
+	StateSaveSnapshot	savesnapshot;
+}
+
+/*
+ * The file format is not meant to be portable between
+ * machines or SciTECO builds.
+ * The version is also used to detect foreign byte orders.
+ */
+#define SNAPSHOT_MAGIC		"TECOSNAP"
+#define SNAPSHOT_VERSION	4
+
+enum {
+	/** Global Q-Registers (EP) */
+	SNAPSHOT_QREGISTERS = 0,
+	/** Editor state image (--dump-image) */
+	SNAPSHOT_IMAGE
+};
+
+namespace Snapshot {
+	/** Whether munged files are currently recorded */
+	static bool recording = false;
+	/** Files munged so far */
+	static SnapshotSourceTable sources;
+	/** Files whose effects have been restored */
+	static SnapshotSourceTable restored;
+}
+
+static inline bool
+get_mtime(const gchar *filename, gint64 &mtime)
+{
+	GStatBuf st;
+
+	if (g_stat(filename, &st))
+		return false;
+
+	mtime = st.st_mtime;
+	return true;
+}
+
+void
+SnapshotWriter::save(const gchar *filename)
+{
+	GError *error = NULL;
+
+	if (!g_file_set_contents(filename, buffer->str, buffer->len, &error))
+		throw GlibError(error);
+}
+
+void
+SnapshotSourceTable::set(const gchar *filename, gint64 mtime)
+{
+	Source *source = (Source *)find(filename);
+
+	if (source)
+		source->mtime = mtime;
+	else
+		insert(new Source(filename, mtime));
+}
+
+/**
+ * Remove a file from the table if it has not been
+ * modified since it was added.
+ *
+ * @param filename Absolute file name.
+ * @return True if the file was removed.
+ */
+bool
+SnapshotSourceTable::remove_current(const gchar *filename)
+{
+	Source *source = (Source *)find(filename);
+	gint64 mtime;
+
+	if (!source || !get_mtime(filename, mtime) ||
+	    mtime != source->mtime)
+		return false;
+
+	delete (Source *)RBTreeString::remove(source);
+	return true;
+}
+
+void
+SnapshotSourceTable::write(SnapshotWriter &writer)
+{
+	guint32 count = 0;
+
+	for (Source *cur = (Source *)min(); cur; cur = (Source *)cur->next())
+		count++;
+	writer.write(count);
+
+	for (Source *cur = (Source *)min(); cur; cur = (Source *)cur->next()) {
+		writer.write_string(cur->key);
+		writer.write(cur->mtime);
+	}
+}
+
+/**
+ * Read the table from a snapshot, replacing the
+ * current contents.
+ *
+ * @return False if the data is corrupt or any of the
+ *         files has been modified in the meantime.
+ */
+bool
+SnapshotSourceTable::read(SnapshotReader &reader)
+{
+	guint32 count;
+
+	clear();
+
+	if (!reader.read(count))
+		return false;
+
+	while (count--) {
+		const gchar *filename_data;
+		gsize filename_len;
+		gint64 mtime, cur_mtime;
+
+		filename_data = reader.read_string(filename_len);
+		if (!filename_data || !reader.read(mtime))
+			return false;
+
+		gchar *filename = g_strndup(filename_data, filename_len);
+		bool valid = get_mtime(filename, cur_mtime) && cur_mtime == mtime;
+
+		if (valid)
+			set(filename, mtime);
+		g_free(filename);
+		if (!valid)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Enable or disable recording and skipping of munged files.
+ * This is only enabled while munging the profile,
+ * so munging files in loops or interactively does not
+ * have any overhead and cannot be rubbed out.
+ */
+void
+Snapshot::set_recording(bool enable)
+{
+	recording = enable;
+}
+
+/**
+ * Register a macro file that has been munged,
+ * so it will be recorded in snapshots.
+ */
+void
+Snapshot::add_source(const gchar *filename)
+{
+	gchar *absolute;
+	gint64 mtime;
+
+	if (!recording)
+		return;
+
+	absolute = get_absolute_path(filename);
+
+	if (get_mtime(absolute, mtime))
+		sources.set(absolute, mtime);
+	g_free(absolute);
+}
+
+/**
+ * Check whether munging a macro file can be skipped
+ * since its effects have already been restored from a snapshot.
+ * This is the case only once per file and only if the file
+ * has not been modified since the snapshot was restored.
+ */
+bool
+Snapshot::skip_source(const gchar *filename)
+{
+	gchar *absolute;
+	bool ret;
+
+	if (!recording)
+		return false;
+
+	absolute = get_absolute_path(filename);
+	ret = restored.remove_current(absolute);
+
+	g_free(absolute);
+	return ret;
+}
+
+/*
+ * Special registers and environment registers
+ * (initialized at startup) are not part of snapshots.
+ */
+static inline bool
+is_snapshot_register(QRegister *reg)
+{
+	return typeid(*reg) == typeid(QRegister) && *reg->name != '$';
+}
+
+static void
+write_header(SnapshotWriter &writer, guint32 type)
+{
+	g_string_append_len(writer.buffer, SNAPSHOT_MAGIC,
+	                    sizeof(SNAPSHOT_MAGIC)-1);
+	writer.write<guint32>(SNAPSHOT_VERSION);
+	writer.write<guint32>(sizeof(tecoInt));
+	writer.write(type);
+}
+
+static bool
+read_header(SnapshotReader &reader, guint32 type)
+{
+	gchar magic[sizeof(SNAPSHOT_MAGIC)-1];
+	guint32 version, int_size, cur_type;
+
+	return reader.read(magic) &&
+	       !memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) &&
+	       reader.read(version) && version == SNAPSHOT_VERSION &&
+	       reader.read(int_size) && int_size == sizeof(tecoInt) &&
+	       reader.read(cur_type) && cur_type == type;
+}
+
+static void
+write_registers(SnapshotWriter &writer, QRegisterTable &table)
+{
+	guint32 count = 0;
+	gsize count_offset = writer.buffer->len;
+
+	writer.write(count);
+
+	for (QRegister *cur = table.first();
+	     cur; cur = (QRegister *)cur->next()) {
+		if (!is_snapshot_register(cur))
+			continue;
+
+		SharedString *str = cur->get_shared_string();
+
+		writer.write_string(cur->name);
+		writer.write(cur->get_integer());
+		writer.write<gint32>(cur->get_eol_mode());
+		writer.write_string(str->str, str->len);
+
+		str->unref();
+		count++;
+	}
+
+	memcpy(writer.buffer->str + count_offset, &count, sizeof(count));
+}
+
+/**
+ * Read Q-Registers from a snapshot.
+ *
+ * @param reader The snapshot reader.
+ * @param table The table to restore the registers into.
+ *              If NULL, the data is only checked.
+ * @return False if the data is corrupt.
+ */
+static bool
+read_registers(SnapshotReader &reader, QRegisterTable *table)
+{
+	guint32 count;
+
+	if (!reader.read(count))
+		return false;
+
+	while (count--) {
+		const gchar *name_data, *str;
+		gsize name_len, str_len;
+		tecoInt integer;
+		gint32 eol_mode;
+
+		name_data = reader.read_string(name_len);
+		if (!name_data || !reader.read(integer) ||
+		    !reader.read(eol_mode))
+			return false;
+		str = reader.read_string(str_len);
+		if (!str)
+			return false;
+
+		if (!table)
+			continue;
+
+		gchar *name = g_strndup(name_data, name_len);
+
+		if (*name == '$') {
+			g_free(name);
+			continue;
+		}
+		QRegister *reg = (*table)[name];
+		if (!reg)
+			reg = table->insert(name);
+		else if (!is_snapshot_register(reg))
+			reg = NULL;
+		g_free(name);
+		if (!reg)
+			continue;
+
+		/*
+		 * NOTE: This is only done at startup,
+		 * so there is nothing to undo.
+		 */
+		reg->set_integer(integer);
+		reg->set_string(str, str_len);
+		reg->set_eol_mode(eol_mode);
+	}
+
+	return true;
+}
+
+/**
+ * Write a snapshot of all global Q-Registers
+ * and lexer associations.
+ */
+void
+Snapshot::save(const gchar *filename)
+{
+	SnapshotWriter writer;
+
+	write_header(writer, SNAPSHOT_QREGISTERS);
+	sources.write(writer);
+	write_registers(writer, QRegisters::globals);
+	/* the lexer configurations add them when munged */
+	lexer_table.write(writer);
+
+	writer.save(filename);
+}
+
+/**
+ * Restore global Q-Registers and lexer associations
+ * from a snapshot.
+ *
+ * This should only be called at startup.
+ * The snapshot file is memory-mapped, so its
+ * strings are only copied once.
+ * If the snapshot is restored, munging any of the files
+ * it was generated from will be skipped (once).
+ *
+ * @param filename The snapshot file.
+ * @return True if the snapshot was restored, false if it does
+ *         not exist, is invalid or out of date.
+ */
+bool
+Snapshot::load(const gchar *filename)
+{
+	GMappedFile *file;
+	bool ret = false;
+
+	file = g_mapped_file_new(filename, FALSE, NULL);
+	if (!file)
+		/* probably does not exist yet */
+		return false;
+
+	SnapshotReader reader(g_mapped_file_get_contents(file),
+	                      g_mapped_file_get_length(file));
+
+	if (!read_header(reader, SNAPSHOT_QREGISTERS)) {
+		interface.msg(InterfaceCurrent::MSG_WARNING,
+		              "Ignoring invalid snapshot \"%s\"", filename);
+		goto cleanup;
+	}
+
+	if (!restored.read(reader)) {
+		/* out of date */
+		restored.clear();
+		goto cleanup;
+	}
+
+	/*
+	 * Check the entire snapshot before restoring,
+	 * so we do not leave the registers half-initialized.
+	 */
+	{
+		SnapshotReader check = reader;
+
+		if (!read_registers(check, NULL) ||
+		    !lexer_table.read(check, false) || !check.is_eof()) {
+			interface.msg(InterfaceCurrent::MSG_WARNING,
+			              "Ignoring invalid snapshot \"%s\"", filename);
+			restored.clear();
+			goto cleanup;
+		}
+	}
+
+	read_registers(reader, &QRegisters::globals);
+	lexer_table.read(reader, true);
+	ret = true;
+
+cleanup:
+	g_mapped_file_unref(file);
+	return ret;
+}
+
+static void
+write_editor_state(SnapshotWriter &writer)
+{
+	guint32 count, current = 0;
+
+	writer.write(Flags::ed);
+	writer.write<guint64>(memlimit.limit);
+
+	/* make sure the help index is part of the image */
+	help_index.load();
+	count = 0;
+	for (HelpIndex::Topic *cur = help_index.first();
+	     cur; cur = (HelpIndex::Topic *)cur->next())
+		count++;
+	writer.write(count);
+	for (HelpIndex::Topic *cur = help_index.first();
+	     cur; cur = (HelpIndex::Topic *)cur->next()) {
+		writer.write_string(cur->name);
+		writer.write_string(cur->filename);
+		writer.write(cur->pos);
+	}
+
+	lexer_table.write(writer);
+
+	/*
+	 * Only the buffer file names are recorded,
+	 * the files are reloaded when restoring the image.
+	 */
+	count = 0;
+	for (Buffer *cur = ring.first(); cur; cur = cur->next()) {
+		if (cur == ring.current)
+			current = count;
+		count++;
+	}
+	writer.write(count);
+	writer.write(current);
+	for (Buffer *cur = ring.first(); cur; cur = cur->next())
+		writer.write_string(cur->filename ? : "");
+}
+
+/**
+ * Read the editor state of an image.
+ *
+ * @param reader The snapshot reader.
+ * @param apply If false, the data is only checked.
+ * @return False if the data is corrupt.
+ */
+static bool
+read_editor_state(SnapshotReader &reader, bool apply)
+{
+	tecoInt ed;
+	guint64 limit;
+	guint32 count, current;
+	Buffer *current_buffer = ring.current;
+
+	if (!reader.read(ed) || !reader.read(limit) ||
+	    !reader.read(count))
+		return false;
+
+	if (apply) {
+		Flags::ed = ed;
+		memlimit.set_limit(limit);
+	}
+
+	while (count--) {
+		const gchar *name_data, *filename_data;
+		gsize name_len, filename_len;
+		tecoInt pos;
+
+		name_data = reader.read_string(name_len);
+		if (!name_data)
+			return false;
+		filename_data = reader.read_string(filename_len);
+		if (!filename_data || !reader.read(pos))
+			return false;
+
+		if (!apply)
+			continue;
+
+		gchar *name = g_strndup(name_data, name_len);
+		gchar *filename = g_strndup(filename_data, filename_len);
+
+		help_index.set(name, filename, pos);
+		g_free(name);
+		g_free(filename);
+	}
+
+	if (!lexer_table.read(reader, apply))
+		return false;
+
+	if (!reader.read(count) || !reader.read(current))
+		return false;
+
+	for (guint32 i = 0; i < count; i++) {
+		const gchar *filename_data;
+		gsize filename_len;
+
+		filename_data = reader.read_string(filename_len);
+		if (!filename_data)
+			return false;
+
+		if (!apply)
+			continue;
+
+		/*
+		 * Unnamed buffers are not restored.
+		 * The unnamed buffer created at startup is used instead.
+		 */
+		if (!filename_len)
+			continue;
+
+		gchar *filename = g_strndup(filename_data, filename_len);
+
+		try {
+			ring.edit(filename);
+		} catch (...) {
+			g_free(filename);
+			throw;
+		}
+		g_free(filename);
+		if (i == current)
+			current_buffer = ring.current;
+	}
+
+	if (apply)
+		ring.edit(ring.get_id(current_buffer));
+
+	return true;
+}
+
+/**
+ * Write an image of the editor state.
+ *
+ * This contains the global Q-Registers, the top-level
+ * local Q-Registers, the ED flags, the memory limit,
+ * the help topic index, the lexer associations
+ * and the file names of all buffers
+ * in the ring.
+ * Symbol lists do not have to be saved since they are
+ * compiled into SciTECO.
+ */
+void
+Snapshot::dump_image(const gchar *filename)
+{
+	SnapshotWriter writer;
+
+	write_header(writer, SNAPSHOT_IMAGE);
+	sources.write(writer);
+	write_registers(writer, QRegisters::globals);
+	write_registers(writer, *QRegisters::locals);
+	write_editor_state(writer);
+
+	writer.save(filename);
+}
+
+/**
+ * Restore the editor state from an image written
+ * by dump_image().
+ *
+ * This should only be called at startup, after the
+ * unnamed buffer has been created and instead of munging
+ * the profile.
+ * Errors in ring hooks are propagated.
+ *
+ * @param filename The image file.
+ * @return True if the image was restored, false if it does
+ *         not exist, is invalid or out of date.
+ */
+bool
+Snapshot::load_image(const gchar *filename)
+{
+	GMappedFile *file;
+	bool ret = false;
+
+	file = g_mapped_file_new(filename, FALSE, NULL);
+	if (!file)
+		return false;
+
+	SnapshotReader reader(g_mapped_file_get_contents(file),
+	                      g_mapped_file_get_length(file));
+
+	if (!read_header(reader, SNAPSHOT_IMAGE)) {
+		interface.msg(InterfaceCurrent::MSG_WARNING,
+		              "Ignoring invalid image \"%s\"", filename);
+		goto cleanup;
+	}
+
+	/*
+	 * The files the image has been generated from are
+	 * recorded again, so the image can be dumped again.
+	 */
+	if (!sources.read(reader)) {
+		sources.clear();
+		goto cleanup;
+	}
+
+	{
+		SnapshotReader check = reader;
+
+		if (!read_registers(check, NULL) ||
+		    !read_registers(check, NULL) ||
+		    !read_editor_state(check, false) || !check.is_eof()) {
+			interface.msg(InterfaceCurrent::MSG_WARNING,
+			              "Ignoring invalid image \"%s\"", filename);
+			sources.clear();
+			goto cleanup;
+		}
+	}
+
+	try {
+		read_registers(reader, &QRegisters::globals);
+		read_registers(reader, QRegisters::locals);
+		read_editor_state(reader, true);
+	} catch (...) {
+		g_mapped_file_unref(file);
+		throw;
+	}
+	ret = true;
+
+cleanup:
+	g_mapped_file_unref(file);
+	return ret;
+}
+
+/*
+ * Command states
+ */
+
+/*$ EP snapshot
+ * EP<file>$ -- Save Q-Register snapshot
+ *
+ * Writes the strings, integers and EOL modes of all global
+ * Q-Registers into the binary snapshot <file>.
+ * Special registers like the environment registers are
+ * not saved.
+ * The lexer associations added with \fBEA\fP are saved
+ * as well.
+ * The snapshot also records all files that have been munged
+ * with \fBEM\fP by the profile so far, along with their
+ * modification times.
+ *
+ * When \*(ST is started with the \fB--snapshot\fP option,
+ * the Q-Registers and lexer associations are restored
+ * from the snapshot unless
+ * any of the recorded files has been modified.
+ * Munging any of these files with \fBEM\fP from the profile
+ * will then do nothing the first time, as its effects
+ * on the Q-Registers have already been restored.
+ * All other effects of these files, e.g. on the \fBED\fP
+ * flags, the \fBEJ\fP properties or the buffer ring,
+ * are lost.
+ * Therefore, only files that do nothing but define
+ * Q-Registers and lexer associations, as the standard
+ * library macros,
+ * should be munged before writing a snapshot.
+ *
+ * The snapshot is written immediately and is not
+ * removed on rubout.
+ */
+State *
+StateSaveSnapshot::got_file(const gchar *filename)
+{
+	BEGIN_EXEC(&States::start);
+	Snapshot::save(filename);
+
+	return &States::start;
+}
+
+} /* namespace SciTECO */
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2012-2017 Robin Haberkorn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SNAPSHOT_H
+#define __SNAPSHOT_H
+
+#include <string.h>
+
+#include <glib.h>
+
+#include "sciteco.h"
+#include "memory.h"
+#include "parser.h"
+#include "rbtree.h"
+
+namespace SciTECO {
+
+/**
+ * Serializes snapshot data in native byte order.
+ */
+class SnapshotWriter : public Object {
+public:
+	GString *buffer;
+
+	SnapshotWriter() : buffer(g_string_new(NULL)) {}
+	~SnapshotWriter()
+	{
+		g_string_free(buffer, TRUE);
+	}
+
+	template <typename Type>
+	inline void
+	write(Type value)
+	{
+		g_string_append_len(buffer, (const gchar *)&value, sizeof(value));
+	}
+
+	inline void
+	write_string(const gchar *str, gsize len)
+	{
+		write<guint64>(len);
+		g_string_append_len(buffer, str, len);
+	}
+	inline void
+	write_string(const gchar *str)
+	{
+		write_string(str, strlen(str));
+	}
+
+	void save(const gchar *filename);
+};
+
+/**
+ * Deserializes snapshot data, usually from a memory-mapped file.
+ * The data is not copied and must not be freed before the reader.
+ * All methods fail if the data is truncated.
+ */
+class SnapshotReader : public Object {
+	const gchar *p, *end;
+
+public:
+	SnapshotReader(const gchar *data, gsize len)
+	              : p(data), end(data + len) {}
+
+	template <typename Type>
+	inline bool
+	read(Type &value)
+	{
+		if ((gsize)(end - p) < sizeof(value))
+			return false;
+		/* the data might not be aligned */
+		memcpy(&value, p, sizeof(value));
+		p += sizeof(value);
+		return true;
+	}
+
+	/**
+	 * Read a string.
+	 *
+	 * @param len Length of the string.
+	 * @return Pointer to the string, which is
+	 *         not null-terminated, or NULL on error.
+	 */
+	inline const gchar *
+	read_string(gsize &len)
+	{
+		guint64 len64;
+		const gchar *ret;
+
+		if (!read(len64) || (guint64)(end - p) < len64)
+			return NULL;
+		ret = p;
+		p += len64;
+		len = len64;
+		return ret;
+	}
+
+	inline bool
+	is_eof(void)
+	{
+		return p == end;
+	}
+};
+
+/**
+ * Table of macro files (munged with EM) and their
+ * modification times.
+ * It is used to validate Q-Register snapshots
+ * against the files they have been generated from.
+ */
+class SnapshotSourceTable : private RBTreeString, public Object {
+	class Source : public RBTreeString::RBEntryOwnString {
+	public:
+		gint64 mtime;
+
+		Source(const gchar *filename, gint64 _mtime)
+		      : RBEntryOwnString(filename), mtime(_mtime) {}
+	};
+
+public:
+	~SnapshotSourceTable()
+	{
+		clear();
+	}
+
+	void set(const gchar *filename, gint64 mtime);
+	bool remove_current(const gchar *filename);
+
+	void write(SnapshotWriter &writer);
+	bool read(SnapshotReader &reader);
+
+	inline void
+	clear(void)
+	{
+		Source *cur;
+
+		while ((cur = (Source *)root()))
+			delete (Source *)RBTreeString::remove(cur);
+	}
+};
+
+namespace Snapshot {
+	void set_recording(bool enable);
+	void add_source(const gchar *filename);
+	bool skip_source(const gchar *filename);
+
+	void save(const gchar *filename);
+	bool load(const gchar *filename);
+
+	void dump_image(const gchar *filename);
+	bool load_image(const gchar *filename);
+}
+
+/*
+ * Command states
+ */
+
+class StateSaveSnapshot : public StateExpectFile {
+private:
+	State *got_file(const gchar *filename);
+};
+
+namespace States {
+	extern StateSaveSnapshot	savesnapshot;
+}
+
+} /* namespace SciTECO */
+
+#endif
@@ -28,34 +28,78 @@
 
 namespace SciTECO {
 
+/**
+ * Continue a DJB hash with the first `len` characters of `str`.
+ * Case-insensitive lists hash the lower-case characters.
+ */
+guint
+SymbolList::hash(const gchar *str, gsize len, guint h)
+{
+	for (gsize i = 0; i < len && str[i]; i++)
+		h = h*33 + (case_sensitive ? str[i] : g_ascii_tolower(str[i]));
+
+	return h;
+}
+
 /*
- * Since symbol lists are presorted constant arrays we can do a simple
- * binary search.
+ * Since the generated symbol arrays contain conditionally
+ * compiled entries, the hash table cannot be generated
+ * along with them.
+ * Instead it is built once, so every lookup is O(1).
+ */
+void
+SymbolList::build_table(void)
+{
+	guint table_size = 1;
+
+	/* keep the load factor below 50% */
+	while (table_size < (guint)size*2)
+		table_size <<= 1;
+	table_mask = table_size - 1;
+
+	table = g_new(gint, table_size);
+	memset(table, -1, table_size*sizeof(gint));
+
+	for (gint i = 0; i < size; i++) {
+		guint slot = hash(entries[i].name, G_MAXSIZE) & table_mask;
+
+		while (table[slot] >= 0)
+			slot = (slot + 1) & table_mask;
+		table[slot] = i;
+	}
+}
+
+/**
+ * Look up the value of a symbol.
+ *
+ * @param name The symbol's name.
+ * @param prefix Prefix of the symbols in the list
+ *               that may be omitted in `name`.
+ * @return The symbol's value or -1 if it is not found.
  */
 gint
 SymbolList::lookup(const gchar *name, const gchar *prefix)
 {
-	gint prefix_skip = strlen(prefix);
-	gint name_len = strlen(name);
-
-	gint left = 0;
-	gint right = size - 1;
+	gsize prefix_len = strlen(prefix);
+	gsize name_len = strlen(name);
 
-	if (!cmp_fnc(name, prefix, prefix_skip))
-		prefix_skip = 0;
+	if (!size)
+		return -1;
+	if (!table)
+		build_table();
 
-	while (left <= right) {
-		gint cur = left + (right-left)/2;
-		gint cmp = cmp_fnc(entries[cur].name + prefix_skip,
-				   name, name_len + 1);
+	if (!cmp_fnc(name, prefix, prefix_len))
+		prefix_len = 0;
 
-		if (!cmp)
-			return entries[cur].value;
+	for (guint slot = hash(name, G_MAXSIZE,
+	                       hash(prefix, prefix_len)) & table_mask;
+	     table[slot] >= 0;
+	     slot = (slot + 1) & table_mask) {
+		const Entry &entry = entries[table[slot]];
 
-		if (cmp > 0)
-			right = cur-1;
-		else /* cmp < 0 */
-			left = cur+1;
+		if (!cmp_fnc(entry.name, prefix, prefix_len) &&
+		    !cmp_fnc(entry.name + prefix_len, name, name_len + 1))
+			return entry.value;
 	}
 
 	return -1;
@@ -35,15 +35,28 @@ public:
 private:
 	const Entry	*entries;
 	gint		size;
+	bool		case_sensitive;
 	int		(*cmp_fnc)(const char *, const char *, size_t);
 
+	/*
+	 * Open addressing hash table of indices into `entries`
+	 * (-1 for empty slots), built on the first lookup
+	 */
+	gint		*table;
+	guint		table_mask;
+
 	/* for auto-completions */
 	GList		*list;
 
+	guint hash(const gchar *str, gsize len, guint h = 5381);
+	void build_table(void);
+
 public:
 	SymbolList(const Entry *_entries = NULL, gint _size = 0,
-		   bool case_sensitive = false)
-		  : entries(_entries), size(_size), list(NULL)
+		   bool _case_sensitive = false)
+		  : entries(_entries), size(_size),
+		    case_sensitive(_case_sensitive),
+		    table(NULL), table_mask(0), list(NULL)
 	{
 		cmp_fnc = case_sensitive ? strncmp
 					 : g_ascii_strncasecmp;
@@ -51,6 +64,7 @@ public:
 
 	~SymbolList()
 	{
+		g_free(table);
 		g_list_free(list);
 	}
 